@@ -6,6 +6,7 @@
 #include <sys/mman.h>
 
 #include "arena.h"
+#include "stats.h"
 
 #define ARENA_ALIGNMENT sizeof(void*)
 
@@ -19,15 +20,23 @@ Arena* arena_create(size_t capacity) {
         return NULL;
     }
 
+    WISP_STAT_ARENA_LINK();
     arena->capacity = capacity;
     arena->offset = 0;
+    arena->next = NULL;
+    memset(arena->free_lists, 0, sizeof(arena->free_lists));
+    memset(arena->recycled, 0, sizeof(arena->recycled));
+    memset(arena->reused, 0, sizeof(arena->reused));
     return arena;
 }
 
 void arena_free(Arena* arena) {
-    if (!arena) return;
-    munmap(arena->start, arena->capacity);
-    free(arena);
+    while (arena) {
+        Arena* next = arena->next;
+        munmap(arena->start, arena->capacity);
+        free(arena);
+        arena = next;
+    }
 }
 
 void* arena_alloc(Arena** arena_ptr, size_t size) {
@@ -37,6 +46,20 @@ void* arena_alloc(Arena** arena_ptr, size_t size) {
 
     Arena* current_arena = *arena_ptr;
 
+    WISP_STAT_ALLOC(size);
+
+    /* Recycled blocks first: a class-k list only holds blocks of at
+     * least (k+1)*8 bytes, so any hit fits the request. */
+    if (size <= ARENA_MAX_RECYCLE) {
+        size_t k = (size - 1) / 8;
+        FreeBlock* block = current_arena->free_lists[k];
+        if (block) {
+            current_arena->free_lists[k] = block->next;
+            current_arena->reused[k]++;
+            return block;
+        }
+    }
+
     uintptr_t current_ptr = (uintptr_t)current_arena->start + current_arena->offset;
     uintptr_t aligned_ptr = (current_ptr + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
     size_t aligned_offset = aligned_ptr - (uintptr_t)current_arena->start;
@@ -54,6 +77,13 @@ void* arena_alloc(Arena** arena_ptr, size_t size) {
         }
         current_arena->next = new_arena;
 
+        /* Carry the free lists to the new cursor link so recycled
+         * blocks stay reachable; counters stay put for arena_stats. */
+        for (size_t k = 0; k < ARENA_NUM_CLASSES; k++) {
+            new_arena->free_lists[k] = current_arena->free_lists[k];
+            current_arena->free_lists[k] = NULL;
+        }
+
         *arena_ptr = new_arena;
 
         void* ptr = new_arena->start;
@@ -66,8 +96,48 @@ void* arena_alloc(Arena** arena_ptr, size_t size) {
     return ptr;
 }
 
+void arena_recycle(Arena* arena, void* ptr, size_t size) {
+    if (!arena || !ptr || size < 8 || size > ARENA_MAX_RECYCLE) {
+        return;
+    }
+    /* Round DOWN: the block must cover every request its class serves. */
+    size_t k = size / 8 - 1;
+    FreeBlock* block = (FreeBlock*)ptr;
+    block->next = arena->free_lists[k];
+    arena->free_lists[k] = block;
+    arena->recycled[k]++;
+}
+
+void arena_stats(const Arena* head, ArenaStats* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    for (const Arena* a = head; a; a = a->next) {
+        out->links++;
+        out->capacity += a->capacity;
+        out->allocated += a->offset;
+        if (a->next) {
+            out->wasted += a->capacity - a->offset;
+        }
+        for (size_t k = 0; k < ARENA_NUM_CLASSES; k++) {
+            out->recycled[k] += a->recycled[k];
+            out->reused[k] += a->reused[k];
+        }
+    }
+}
+
 void arena_reset(Arena* arena) {
     if (arena) {
         arena->offset = 0;
+        /* Recycled blocks point into the region being reclaimed. */
+        memset(arena->free_lists, 0, sizeof(arena->free_lists));
     }
 }
+
+Arena* arena_reset_chain(Arena* head) {
+    if (!head) return NULL;
+    arena_free(head->next);
+    head->next = NULL;
+    head->offset = 0;
+    memset(head->free_lists, 0, sizeof(head->free_lists));
+    return head;
+}
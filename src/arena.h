@@ -11,6 +11,19 @@
 
 #include "vec.h"
 
+/// Number of recycling size classes, 8 bytes apart (8..64 bytes).
+/// Interpreter workloads churn through huge numbers of same-sized small
+/// objects (Cons headers, ConsList headers, SymRef-sized atoms); larger
+/// blocks are rare enough that recycling them is not worth the bookkeeping.
+#define ARENA_NUM_CLASSES 8
+#define ARENA_MAX_RECYCLE (ARENA_NUM_CLASSES * 8)
+
+/// Link threaded through recycled blocks; every class is at least
+/// pointer-sized so the freed block stores its own list node.
+typedef struct FreeBlock {
+    struct FreeBlock* next;
+} FreeBlock;
+
 /*
  * @struct Arena main struct
  */
@@ -19,8 +32,26 @@ typedef struct Arena {
     size_t capacity;   ///< Total size of the memory block in bytes
     size_t offset;     ///< Current position/offset for next allocation
     struct Arena* next; ///< Pointer to next arena in linked list (for chaining)
+
+    FreeBlock* free_lists[ARENA_NUM_CLASSES]; ///< Recycled blocks by size class
+    size_t recycled[ARENA_NUM_CLASSES];       ///< arena_recycle calls per class
+    size_t reused[ARENA_NUM_CLASSES];         ///< Allocations served from a free list
 } Arena;
 
+/**
+ * @struct ArenaStats
+ * @brief Snapshot of a chain's memory behaviour, for sizing arenas from
+ *        data instead of guesswork.
+ */
+typedef struct ArenaStats {
+    size_t links;       ///< Number of links in the chain
+    size_t capacity;    ///< Total mapped bytes across the chain
+    size_t allocated;   ///< Bytes handed out by bump allocation
+    size_t wasted;      ///< Tail bytes stranded in filled (non-cursor) links
+    size_t recycled[ARENA_NUM_CLASSES]; ///< arena_recycle calls per class
+    size_t reused[ARENA_NUM_CLASSES];   ///< Free-list hits per class
+} ArenaStats;
+
 /**
  * Creates a new memory arena with the specified capacity.
  * 
@@ -51,6 +82,30 @@ void arena_free(Arena* arena);
  */
 void* arena_alloc(Arena** arena_ptr, size_t size);
 
+/**
+ * @brief Return a dead block to the arena for reuse by arena_alloc.
+ *
+ * The block must have come from this chain and must be provably
+ * unreachable — the evaluator uses this for short-lived headers it
+ * allocates and drops on every call. Blocks smaller than a class or
+ * larger than ARENA_MAX_RECYCLE are ignored; a block is filed under the
+ * largest class it fully covers, so a later allocation served from that
+ * class always fits.
+ *
+ * @param arena The current chain link (the allocation cursor).
+ * @param ptr   Block to recycle; may be NULL (no-op).
+ * @param size  The size the block was allocated with.
+ */
+void arena_recycle(Arena* arena, void* ptr, size_t size);
+
+/**
+ * @brief Sum allocation counters and occupancy over a chain.
+ *
+ * Walks the links reachable from @p head (note that arena_alloc advances
+ * the caller's cursor, so pass the earliest link still on hand).
+ */
+void arena_stats(const Arena* head, ArenaStats* out);
+
 
 /* ----------------- Macro for Vec* in Arenas ---------- */
 
@@ -119,4 +174,13 @@ static inline int arena_vec_push(Vec** vec_ptr, const void* elem, Arena** arena)
 
 void arena_reset(Arena* arena);
 
+/**
+ * @brief Bulk-reset a whole arena chain for reuse.
+ *
+ * Keeps the first link's mapping (offset back to 0) and releases every
+ * chained overflow link. Returns the head so callers can re-seat the
+ * allocation cursor that arena_alloc advanced.
+ */
+Arena* arena_reset_chain(Arena* head);
+
 #endif
@@ -0,0 +1,277 @@
+/*
+ * @file bench.c
+ * @brief Corpus benchmark harness (the wisp-bench target).
+ *
+ * Runs each .wisp file given on the command line through the pipeline
+ * with every stage timed separately via clock_gettime(CLOCK_MONOTONIC):
+ * a standalone lex pass (token throughput), parse_stream (which lexes
+ * internally — its time includes lexing), eval_program, and the bytecode
+ * tier (compile_program then vm_run, @see vm.h). Each file is repeated
+ * to steady state (warmup reps discarded, minimum of the measured reps
+ * reported) with fresh arenas per rep so allocation is measured
+ * honestly.
+ *
+ * Output is one machine-readable key=value record per file on stdout:
+ *
+ *   wisp-bench file=... reps=... tokens=... cells=... lex_ns=...
+ *       parse_ns=... eval_ns=... compile_ns=... vm_ns=...
+ *       tokens_per_s=... cells_per_s=... arena_bytes=... peak_rss_kb=...
+ *
+ * tokens_per_s derives from the lex minimum, cells_per_s from the parse
+ * minimum; arena_bytes is the persistent chain high-water after eval.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "arena.h"
+#include "eval.h"
+#include "intern.h"
+#include "lexer.h"
+#include "parser.h"
+#include "passes.h"
+#include "readfile.h"
+#include "symtab.h"
+#include "vm.h"
+
+#define BENCH_WARMUP_REPS 3
+#define BENCH_DEFAULT_REPS 10
+#define BENCH_SCRATCH_SIZE (1024 * 1024)
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* ------------------ Counters ------------------ */
+
+static size_t count_cells_list(const ConsList* list);
+
+static size_t count_cells(const Cons* c) {
+    if (!c) return 0;
+    switch (c->type) {
+        case NODE_LIST: {
+            const ConsList* sub = *(ConsList* const*)c->car;
+            return 1 + (sub ? count_cells_list(sub) : 0);
+        }
+        case NODE_QUOTE:
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE:
+            return 1 + count_cells(*(Cons* const*)c->car);
+        case NODE_VECTOR_LIST: {
+            const VecList* v = (const VecList*)c->car;
+            size_t n = 1;
+            for (size_t i = 0; i < v->count; i++) n += count_cells(v->items[i]);
+            return n;
+        }
+        default:
+            return 1;
+    }
+}
+
+static size_t count_cells_list(const ConsList* list) {
+    size_t n = 0;
+    for (const Cons* c = list->head; c; c = c->cdr) {
+        n += count_cells(c);
+    }
+    return n;
+}
+
+/* High-water of a whole arena chain, from its head. */
+static size_t arena_chain_bytes(const Arena* head) {
+    size_t n = 0;
+    for (const Arena* a = head; a; a = a->next) {
+        n += a->offset;
+    }
+    return n;
+}
+
+/* ------------------ Per-file run ------------------ */
+
+typedef struct BenchResult {
+    size_t tokens;
+    size_t cells;
+    uint64_t lex_ns;
+    uint64_t parse_ns;
+    uint64_t eval_ns;
+    uint64_t compile_ns;
+    uint64_t vm_ns;
+    size_t arena_bytes;
+} BenchResult;
+
+/* One rep: fresh arenas, all stages. Returns 0 on success. */
+static int bench_rep(const FileBuffer* file, BenchResult* out) {
+    size_t initial = (file->size > 1024 * 1024) ? file->size * 2 : 2 * 1024 * 1024;
+    Arena* persistent_head = arena_create(initial);
+    if (!persistent_head) return -1;
+    Arena* persistent = persistent_head;
+
+    /* Lex pass: pure token throughput, nothing retained. */
+    uint64_t t0 = now_ns();
+    LexState ls;
+    lex_init(&ls, file->data, file->size);
+    size_t tokens = 0;
+    for (;;) {
+        Token tok = lex_next(&ls);
+        if (tok.type == TOKEN_EOF) break;
+        tokens++;
+    }
+    uint64_t t1 = now_ns();
+
+    ConsList* program = parse_stream(file->data, file->size, &persistent);
+    if (program) {
+        expand_quasiquote(program, &persistent);
+        resolve_builtins(program);
+        fold_constants(program, &persistent);
+        resolve_locals(program, &persistent);
+        vectorize_quoted(program, &persistent);
+    }
+    uint64_t t2 = now_ns();
+    if (!program) {
+        arena_free(persistent_head);
+        return -1;
+    }
+
+    Arena* scratch_head = arena_create(BENCH_SCRATCH_SIZE);
+    if (!scratch_head) {
+        arena_free(persistent_head);
+        return -1;
+    }
+    Arena* scratch = scratch_head;
+
+    Symtab* globals = symtab_new(NULL, &persistent);
+    uint64_t t3 = now_ns();
+    Cons* result = globals ? eval_program(program, globals, &scratch) : NULL;
+    uint64_t t4 = now_ns();
+
+    /* Bytecode tier: same program, fresh globals in a single arena so
+     * the run is isolated from the tree walk above (top-level side
+     * effects such as display do repeat). */
+    Arena* vm_head = arena_create(BENCH_SCRATCH_SIZE);
+    if (!vm_head) {
+        arena_free(scratch_head);
+        arena_free(persistent_head);
+        return -1;
+    }
+    Arena* vm_arena = vm_head;
+
+    uint64_t t5 = now_ns();
+    Chunk* chunk = compile_program(program, &persistent);
+    uint64_t t6 = now_ns();
+    Symtab* vm_globals = chunk ? symtab_new(NULL, &vm_arena) : NULL;
+    Cons* vm_result = vm_globals ? vm_run(chunk, vm_globals, &vm_arena) : NULL;
+    uint64_t t7 = now_ns();
+
+    out->tokens = tokens;
+    out->cells = count_cells_list(program);
+    out->lex_ns = t1 - t0;
+    out->parse_ns = t2 - t1;
+    out->eval_ns = t4 - t3;
+    out->compile_ns = t6 - t5;
+    out->vm_ns = t7 - t6;
+    out->arena_bytes = arena_chain_bytes(persistent_head);
+
+    arena_free(vm_head);
+    arena_free(scratch_head);
+    arena_free(persistent_head);
+    return (result && vm_result) ? 0 : -1;
+}
+
+static double per_second(size_t count, uint64_t ns) {
+    if (ns == 0) return 0.0;
+    return (double)count * 1e9 / (double)ns;
+}
+
+static int bench_file(const char* path, int reps) {
+    FileBuffer* file = read_file(path);
+    if (!file) {
+        fprintf(stderr, "wisp-bench: failed to read '%s'\n", path);
+        return -1;
+    }
+
+    BenchResult best = { 0 };
+    BenchResult rep = { 0 };
+
+    for (int i = 0; i < BENCH_WARMUP_REPS + reps; i++) {
+        if (bench_rep(file, &rep) != 0) {
+            fprintf(stderr, "wisp-bench: run failed on '%s'\n", path);
+            filebuffer_free(file);
+            return -1;
+        }
+        if (i < BENCH_WARMUP_REPS) continue;
+
+        /* Steady state: keep the per-stage minima. */
+        if (i == BENCH_WARMUP_REPS) {
+            best = rep;
+        } else {
+            if (rep.lex_ns < best.lex_ns) best.lex_ns = rep.lex_ns;
+            if (rep.parse_ns < best.parse_ns) best.parse_ns = rep.parse_ns;
+            if (rep.eval_ns < best.eval_ns) best.eval_ns = rep.eval_ns;
+            if (rep.compile_ns < best.compile_ns) best.compile_ns = rep.compile_ns;
+            if (rep.vm_ns < best.vm_ns) best.vm_ns = rep.vm_ns;
+        }
+    }
+
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+
+    printf("wisp-bench file=%s reps=%d tokens=%zu cells=%zu "
+           "lex_ns=%" PRIu64 " parse_ns=%" PRIu64 " eval_ns=%" PRIu64 " "
+           "compile_ns=%" PRIu64 " vm_ns=%" PRIu64 " "
+           "tokens_per_s=%.0f cells_per_s=%.0f arena_bytes=%zu peak_rss_kb=%ld\n",
+           path, reps, best.tokens, best.cells,
+           best.lex_ns, best.parse_ns, best.eval_ns,
+           best.compile_ns, best.vm_ns,
+           per_second(best.tokens, best.lex_ns),
+           per_second(best.cells, best.parse_ns),
+           best.arena_bytes, ru.ru_maxrss);
+
+    filebuffer_free(file);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int reps = BENCH_DEFAULT_REPS;
+    int first_file = 1;
+
+    if (argc > 2 && strcmp(argv[1], "-r") == 0) {
+        reps = atoi(argv[2]);
+        if (reps <= 0) reps = BENCH_DEFAULT_REPS;
+        first_file = 3;
+    }
+
+    if (first_file >= argc) {
+        fprintf(stderr, "Usage: %s [-r reps] <file.wisp>...\n", argv[0]);
+        return -1;
+    }
+
+    /* The intern pool keeps an Arena** for its whole lifetime; give it
+     * one that outlives the per-rep arenas. */
+    Arena* pool_arena = arena_create(1024 * 1024);
+    if (!pool_arena) {
+        fprintf(stderr, "wisp-bench: failed to create intern pool arena\n");
+        return -1;
+    }
+    static Arena* pool_cursor;
+    pool_cursor = pool_arena;
+    if (intern_init(&pool_cursor) != 0) {
+        fprintf(stderr, "wisp-bench: intern pool init failed\n");
+        return -1;
+    }
+
+    int rc = 0;
+    for (int i = first_file; i < argc; i++) {
+        if (bench_file(argv[i], reps) != 0) rc = -1;
+    }
+
+    arena_free(pool_arena);
+    return rc;
+}
@@ -0,0 +1,675 @@
+/*
+ * @file builtins.c
+ */
+#include "builtins.h"
+#include "cells.h"
+#include "intern.h"
+#include "parser.h"
+#include "value.h"
+#include "writer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ------------ Name resolution ------------ */
+
+/*
+ * Names added since the last gperf regeneration of find_builtin.c.
+ * gperf is not part of every build environment, so new builtins land
+ * here first and get folded into the perfect hash (and removed from
+ * this table) the next time docs/builtins.gperf is regenerated.
+ */
+static struct BuiltinName builtin_extra_names[] = {
+    { "pmap", BUILTIN_PMAP },
+};
+
+struct BuiltinName* find_builtin(const char* str, size_t len) {
+    struct BuiltinName* b = find_builtin_perfect(str, len);
+    if (b) return b;
+
+    for (size_t i = 0;
+         i < sizeof(builtin_extra_names) / sizeof(builtin_extra_names[0]);
+         i++) {
+        if (strlen(builtin_extra_names[i].name) == len &&
+            memcmp(builtin_extra_names[i].name, str, len) == 0) {
+            return &builtin_extra_names[i];
+        }
+    }
+    return NULL;
+}
+
+/* ------------ Value construction helpers ------------ */
+
+/*
+ * Truth convention: NODE_NIL is the only false value; predicates return
+ * the integer 1 for true and nil for false.
+ */
+
+static Cons* make_int(long long v, Arena** arena) {
+    Cons* shared = cell_int(v);
+    if (shared) return shared;
+    return make_atom(&v, sizeof(v), NODE_ATOM_INT, arena);
+}
+
+static Cons* make_float(long double v, Arena** arena) {
+    return make_atom(&v, sizeof(v), NODE_ATOM_FLOAT, arena);
+}
+
+static Cons* make_nil(Arena** arena) {
+    (void)arena;
+    return cell_nil();
+}
+
+static Cons* make_bool(bool b, Arena** arena) {
+    (void)arena;
+    return cell_bool(b);
+}
+
+/* ------------ Numeric helpers ------------ */
+
+static bool cons_is_number(const Cons* c) {
+    return c && (c->type == NODE_ATOM_INT || c->type == NODE_ATOM_FLOAT);
+}
+
+static long long cons_as_int(const Cons* c) {
+    return *(const long long*)c->car;
+}
+
+static long double cons_as_float(const Cons* c) {
+    if (c->type == NODE_ATOM_FLOAT) return *(const long double*)c->car;
+    return (long double)cons_as_int(c);
+}
+
+/* ------------ Arithmetic ------------ */
+
+/*
+ * Unboxed accumulator for the numeric kernels. Arguments are decoded to
+ * machine words exactly once (fixnums via the tagged Value path,
+ * @see value.h); integer arithmetic runs on long long and promotes to
+ * long double the first time a float shows up; the result is boxed
+ * exactly once at the end. This replaces the old two-pass shape (an
+ * args_all_int prescan followed by a typed re-walk of the chain).
+ */
+typedef struct NumAcc {
+    bool is_int;
+    long long i;
+    long double f;
+} NumAcc;
+
+static bool num_load(const Cons* c, NumAcc* out) {
+    Value v = value_from_cons((Cons*)c);
+    if (value_is_fixnum(v)) {
+        out->is_int = true;
+        out->i = value_as_fixnum(v);
+        return true;
+    }
+    if (c->type == NODE_ATOM_INT) {
+        out->is_int = true;
+        out->i = cons_as_int(c);
+        return true;
+    }
+    if (c->type == NODE_ATOM_FLOAT) {
+        out->is_int = false;
+        out->f = *(const long double*)c->car;
+        return true;
+    }
+    return false;
+}
+
+static long double num_as_f(const NumAcc* x) {
+    return x->is_int ? (long double)x->i : x->f;
+}
+
+static void acc_demote(NumAcc* a) {
+    if (a->is_int) {
+        a->f = (long double)a->i;
+        a->is_int = false;
+    }
+}
+
+static Cons* acc_box(const NumAcc* a, Arena** arena) {
+    if (a->is_int) return make_int(a->i, arena);
+    return make_float(a->f, arena);
+}
+
+Cons* builtin_add(ConsList* args, Arena** arena) {
+    if (!args) return NULL;
+
+    NumAcc acc = { .is_int = true, .i = 0 };
+    for (const Cons* c = args->head; c; c = c->cdr) {
+        NumAcc x;
+        if (!num_load(c, &x)) {
+            fprintf(stderr, "Eval Error: '+' expects numbers.\n");
+            return NULL;
+        }
+        if (acc.is_int && x.is_int) {
+            acc.i += x.i;
+        } else {
+            acc_demote(&acc);
+            acc.f += num_as_f(&x);
+        }
+    }
+    return acc_box(&acc, arena);
+}
+
+Cons* builtin_sub(ConsList* args, Arena** arena) {
+    NumAcc acc;
+    if (!args || !args->head || !num_load(args->head, &acc)) {
+        fprintf(stderr, "Eval Error: '-' expects at least one number.\n");
+        return NULL;
+    }
+
+    if (!args->head->cdr) {
+        if (acc.is_int) acc.i = -acc.i;
+        else acc.f = -acc.f;
+        return acc_box(&acc, arena);
+    }
+
+    for (const Cons* c = args->head->cdr; c; c = c->cdr) {
+        NumAcc x;
+        if (!num_load(c, &x)) {
+            fprintf(stderr, "Eval Error: '-' expects numbers.\n");
+            return NULL;
+        }
+        if (acc.is_int && x.is_int) {
+            acc.i -= x.i;
+        } else {
+            acc_demote(&acc);
+            acc.f -= num_as_f(&x);
+        }
+    }
+    return acc_box(&acc, arena);
+}
+
+Cons* builtin_mul(ConsList* args, Arena** arena) {
+    if (!args) return NULL;
+
+    NumAcc acc = { .is_int = true, .i = 1 };
+    for (const Cons* c = args->head; c; c = c->cdr) {
+        NumAcc x;
+        if (!num_load(c, &x)) {
+            fprintf(stderr, "Eval Error: '*' expects numbers.\n");
+            return NULL;
+        }
+        if (acc.is_int && x.is_int) {
+            acc.i *= x.i;
+        } else {
+            acc_demote(&acc);
+            acc.f *= num_as_f(&x);
+        }
+    }
+    return acc_box(&acc, arena);
+}
+
+Cons* builtin_div(ConsList* args, Arena** arena) {
+    NumAcc first;
+    if (!args || !args->head || !num_load(args->head, &first)) {
+        fprintf(stderr, "Eval Error: '/' expects at least one number.\n");
+        return NULL;
+    }
+
+    bool exact = first.is_int;
+    long long iacc = exact ? first.i : 0;
+    long double facc = num_as_f(&first);
+
+    for (const Cons* c = args->head->cdr; c; c = c->cdr) {
+        NumAcc x;
+        if (!num_load(c, &x)) {
+            fprintf(stderr, "Eval Error: '/' expects numbers.\n");
+            return NULL;
+        }
+        long double d = num_as_f(&x);
+        if (d == 0.0L) {
+            fprintf(stderr, "Eval Error: Division by zero.\n");
+            return NULL;
+        }
+        if (exact && x.is_int && iacc % x.i == 0) iacc /= x.i;
+        else exact = false;
+        facc /= d;
+    }
+
+    /* Exact integer division stays an integer; otherwise fall to float. */
+    if (exact) return make_int(iacc, arena);
+    return make_float(facc, arena);
+}
+
+Cons* builtin_mod(ConsList* args, Arena** arena) {
+    if (!args || args->length != 2 ||
+        args->head->type != NODE_ATOM_INT ||
+        args->head->cdr->type != NODE_ATOM_INT) {
+        fprintf(stderr, "Eval Error: 'mod' expects two integers.\n");
+        return NULL;
+    }
+    long long b = cons_as_int(args->head->cdr);
+    if (b == 0) {
+        fprintf(stderr, "Eval Error: Division by zero.\n");
+        return NULL;
+    }
+    return make_int(cons_as_int(args->head) % b, arena);
+}
+
+/* ------------ Numeric comparisons ------------ */
+
+typedef enum { CMP_EQ, CMP_LT, CMP_GT, CMP_LE, CMP_GE } CmpKind;
+
+static Cons* compare_chain(ConsList* args, CmpKind kind, Arena** arena) {
+    if (!args || args->length < 2) {
+        fprintf(stderr, "Eval Error: Comparison expects at least two numbers.\n");
+        return NULL;
+    }
+
+    /* Decode each element once; a chain of n compares walks n cells. */
+    NumAcc prev;
+    if (!num_load(args->head, &prev)) {
+        fprintf(stderr, "Eval Error: Comparison expects numbers.\n");
+        return NULL;
+    }
+    for (const Cons* c = args->head->cdr; c; c = c->cdr) {
+        NumAcc cur;
+        if (!num_load(c, &cur)) {
+            fprintf(stderr, "Eval Error: Comparison expects numbers.\n");
+            return NULL;
+        }
+        int rel;    /* sign of (prev - cur) */
+        if (prev.is_int && cur.is_int) {
+            rel = (prev.i > cur.i) - (prev.i < cur.i);
+        } else {
+            long double a = num_as_f(&prev);
+            long double b = num_as_f(&cur);
+            rel = (a > b) - (a < b);
+        }
+        bool ok;
+        switch (kind) {
+            case CMP_EQ: ok = (rel == 0); break;
+            case CMP_LT: ok = (rel < 0);  break;
+            case CMP_GT: ok = (rel > 0);  break;
+            case CMP_LE: ok = (rel <= 0); break;
+            default:     ok = (rel >= 0); break;
+        }
+        if (!ok) return make_bool(false, arena);
+        prev = cur;
+    }
+    return make_bool(true, arena);
+}
+
+Cons* builtin_num_eq(ConsList* args, Arena** arena)       { return compare_chain(args, CMP_EQ, arena); }
+Cons* builtin_less_than(ConsList* args, Arena** arena)    { return compare_chain(args, CMP_LT, arena); }
+Cons* builtin_greater_than(ConsList* args, Arena** arena) { return compare_chain(args, CMP_GT, arena); }
+Cons* builtin_less_eq(ConsList* args, Arena** arena)      { return compare_chain(args, CMP_LE, arena); }
+Cons* builtin_greater_eq(ConsList* args, Arena** arena)   { return compare_chain(args, CMP_GE, arena); }
+
+/* ------------ Sequence iteration ------------ */
+
+/*
+ * Proper lists come in two layouts (@see VecList): cdr-chained NODE_LIST
+ * and contiguous NODE_VECTOR_LIST. SeqIter walks either so the list
+ * builtins and equality don't care which one they got.
+ */
+typedef struct SeqIter {
+    const Cons* chain;      ///< NODE_LIST cursor
+    Cons* const* items;     ///< NODE_VECTOR_LIST cursor
+    size_t remaining;
+} SeqIter;
+
+static bool seq_init(SeqIter* it, const Cons* listnode) {
+    if (listnode->type == NODE_LIST) {
+        const ConsList* l = *(ConsList* const*)listnode->car;
+        it->chain = l ? l->head : NULL;
+        it->items = NULL;
+        it->remaining = l ? l->length : 0;
+        return true;
+    }
+    if (listnode->type == NODE_VECTOR_LIST) {
+        const VecList* v = (const VecList*)listnode->car;
+        it->chain = NULL;
+        it->items = v->items;
+        it->remaining = v->count;
+        return true;
+    }
+    return false;
+}
+
+static const Cons* seq_next(SeqIter* it) {
+    if (!it->remaining) return NULL;
+    it->remaining--;
+    if (it->items) return *it->items++;
+    const Cons* c = it->chain;
+    it->chain = c->cdr;
+    return c;
+}
+
+/* ------------ List operations ------------ */
+
+Cons* builtin_cons(ConsList* args, Arena** arena) {
+    if (!args || args->length != 2) {
+        fprintf(stderr, "Eval Error: 'cons' expects two arguments.\n");
+        return NULL;
+    }
+
+    Cons* first = args->head;
+    Cons* rest = args->head->cdr;
+
+    if (rest->type == NODE_VECTOR_LIST) {
+        /* Contiguous layout: prepend by copying the pointer array. */
+        const VecList* v = (const VecList*)rest->car;
+        Cons** items = (Cons**)arena_alloc(arena, (v->count + 1) * sizeof(Cons*));
+        if (!items) return NULL;
+        items[0] = cons_clone_shallow(first, arena);
+        if (!items[0]) return NULL;
+        if (v->count) memcpy(items + 1, v->items, v->count * sizeof(Cons*));
+        return make_vector_list(items, v->count + 1, arena);
+    }
+
+    ConsList* list = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!list) return NULL;
+    cons_list_init(list);
+
+    Cons* head = cons_clone_shallow(first, arena);
+    if (!head) return NULL;
+    cons_list_push_back(list, head);
+
+    if (rest->type == NODE_LIST) {
+        /* Share the tail: cells are immutable once built. */
+        const ConsList* tail = *(ConsList* const*)rest->car;
+        if (tail && tail->head) {
+            list->tail->cdr = tail->head;
+            list->tail = tail->tail;
+            list->length += tail->length;
+        }
+    } else if (rest->type != NODE_NIL) {
+        Cons* second = cons_clone_shallow(rest, arena);
+        if (!second) return NULL;
+        cons_list_push_back(list, second);
+    }
+
+    return wrap_list(list, arena);
+}
+
+Cons* builtin_car(ConsList* args, Arena** arena) {
+    SeqIter it;
+    if (!args || args->length != 1 || !seq_init(&it, args->head)) {
+        fprintf(stderr, "Eval Error: 'car' expects one list.\n");
+        return NULL;
+    }
+    const Cons* first = seq_next(&it);
+    return first ? (Cons*)first : make_nil(arena);
+}
+
+Cons* builtin_cdr(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) {
+        fprintf(stderr, "Eval Error: 'cdr' expects one list.\n");
+        return NULL;
+    }
+
+    if (args->head->type == NODE_VECTOR_LIST) {
+        /* O(1) view into the shared array, one element in. */
+        const VecList* v = (const VecList*)args->head->car;
+        if (v->count <= 1) return make_nil(arena);
+        return make_vector_list(v->items + 1, v->count - 1, arena);
+    }
+
+    if (args->head->type != NODE_LIST) {
+        fprintf(stderr, "Eval Error: 'cdr' expects one list.\n");
+        return NULL;
+    }
+    const ConsList* list = *(ConsList* const*)args->head->car;
+    if (!list || !list->head || !list->head->cdr) return make_nil(arena);
+
+    ConsList* rest = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!rest) return NULL;
+    rest->head = list->head->cdr;
+    rest->tail = list->tail;
+    rest->length = list->length - 1;
+    return wrap_list(rest, arena);
+}
+
+Cons* builtin_list(ConsList* args, Arena** arena) {
+    if (!args) return NULL;
+    if (!args->length) return make_vector_list(NULL, 0, arena);
+
+    /* The element count is known up front: build the contiguous layout. */
+    Cons** items = (Cons**)arena_alloc(arena, args->length * sizeof(Cons*));
+    if (!items) return NULL;
+    size_t i = 0;
+    for (Cons* c = args->head; c; c = c->cdr) items[i++] = c;
+    return make_vector_list(items, args->length, arena);
+}
+
+/* ------------ Predicates ------------ */
+
+Cons* builtin_is_atom(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) return NULL;
+    return make_bool(!is_sublist(args->head), arena);
+}
+
+Cons* builtin_is_pair(ConsList* args, Arena** arena) {
+    SeqIter it;
+    if (!args || args->length != 1) return NULL;
+    if (!seq_init(&it, args->head)) return make_bool(false, arena);
+    return make_bool(it.remaining > 0, arena);
+}
+
+Cons* builtin_is_list(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) return NULL;
+    return make_bool(is_sublist(args->head), arena);
+}
+
+Cons* builtin_is_null(ConsList* args, Arena** arena) {
+    SeqIter it;
+    if (!args || args->length != 1) return NULL;
+    if (args->head->type == NODE_NIL) return make_bool(true, arena);
+    if (seq_init(&it, args->head)) return make_bool(it.remaining == 0, arena);
+    return make_bool(false, arena);
+}
+
+Cons* builtin_is_number(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) return NULL;
+    return make_bool(cons_is_number(args->head), arena);
+}
+
+Cons* builtin_is_string(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) return NULL;
+    return make_bool(args->head->type == NODE_ATOM_STR, arena);
+}
+
+Cons* builtin_is_symbol(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) return NULL;
+    return make_bool(args->head->type == NODE_ATOM_SYM ||
+                     args->head->type == NODE_ATOM_UNINTERNED, arena);
+}
+
+Cons* builtin_is_procedure(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) return NULL;
+    if (args->head->type == NODE_LAMBDA ||
+        args->head->type == NODE_BUILTIN) return make_bool(true, arena);
+    if (args->head->type != NODE_ATOM_SYM) return make_bool(false, arena);
+    const SymRef* ref = (const SymRef*)args->head->car;
+    return make_bool(find_builtin(ref->name, strlen(ref->name)) != NULL, arena);
+}
+
+/* ------------ Equality ------------ */
+
+static bool cons_equal(const Cons* a, const Cons* b);
+
+/* Element-wise compare across either list layout. */
+static bool seq_equal(const Cons* a, const Cons* b) {
+    SeqIter ia, ib;
+    seq_init(&ia, a);
+    seq_init(&ib, b);
+    if (ia.remaining != ib.remaining) return false;
+
+    for (;;) {
+        const Cons* ca = seq_next(&ia);
+        const Cons* cb = seq_next(&ib);
+        if (!ca) return true;
+        if (!cons_equal(ca, cb)) return false;
+    }
+}
+
+static bool cons_equal(const Cons* a, const Cons* b) {
+    if (a == b) return true;
+    if (!a || !b) return false;
+
+    if (cons_is_number(a) && cons_is_number(b))
+        return cons_as_float(a) == cons_as_float(b);
+
+    if (is_sublist(a) && is_sublist(b))
+        return seq_equal(a, b);
+
+    if (a->type != b->type) return false;
+
+    switch (a->type) {
+        case NODE_ATOM_SYM:
+            return sym_ref_eq((const SymRef*)a->car, (const SymRef*)b->car);
+        case NODE_ATOM_STR:
+            return wstr_eq(*(WispStr* const*)a->car, *(WispStr* const*)b->car);
+        case NODE_ATOM_UNINTERNED:
+            return strcmp(*(char* const*)a->car, *(char* const*)b->car) == 0;
+        case NODE_NIL:
+            return true;
+        case NODE_QUOTE:
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE:
+            return cons_equal(*(Cons* const*)a->car, *(Cons* const*)b->car);
+        default:
+            return false;
+    }
+}
+
+Cons* builtin_eq(ConsList* args, Arena** arena) {
+    if (!args || args->length != 2) return NULL;
+    const Cons* a = args->head;
+    const Cons* b = args->head->cdr;
+
+    if (a->type == NODE_ATOM_SYM && b->type == NODE_ATOM_SYM)
+        return make_bool(sym_ref_eq((const SymRef*)a->car, (const SymRef*)b->car), arena);
+    if (a->type == NODE_ATOM_INT && b->type == NODE_ATOM_INT)
+        return make_bool(cons_as_int(a) == cons_as_int(b), arena);
+    if (a->type == NODE_NIL && b->type == NODE_NIL)
+        return make_bool(true, arena);
+
+    return make_bool(a == b, arena);
+}
+
+Cons* builtin_equal(ConsList* args, Arena** arena) {
+    if (!args || args->length != 2) return NULL;
+    return make_bool(cons_equal(args->head, args->head->cdr), arena);
+}
+
+/* ------------ I/O ------------ */
+
+static void display_cons(Writer* w, const Cons* c) {
+    if (!c) {
+        writer_str(w, "nil");
+        return;
+    }
+
+    switch (c->type) {
+        case NODE_ATOM_INT:
+            writer_int(w, cons_as_int(c));
+            break;
+        case NODE_ATOM_FLOAT:
+            writer_float(w, *(const long double*)c->car);
+            break;
+        case NODE_ATOM_SYM:
+            writer_str(w, ((const SymRef*)c->car)->name);
+            break;
+        case NODE_ATOM_STR:
+            writer_str(w, (*(WispStr* const*)c->car)->bytes);
+            break;
+        case NODE_ATOM_UNINTERNED:
+            writer_str(w, *(char* const*)c->car);
+            break;
+        case NODE_NIL:
+            writer_str(w, "nil");
+            break;
+        case NODE_LAMBDA:
+            writer_str(w, "#<lambda>");
+            break;
+        case NODE_BUILTIN:
+            writer_str(w, builtin_type_names[*(const BuiltinType*)c->car]);
+            break;
+        case NODE_LOCAL_REF:
+            writer_str(w, ((const LocalRef*)c->car)->name);
+            break;
+        case NODE_LIST: {
+            const ConsList* list = *(ConsList* const*)c->car;
+            writer_char(w, '(');
+            for (const Cons* cur = list ? list->head : NULL; cur; cur = cur->cdr) {
+                display_cons(w, cur);
+                if (cur->cdr) writer_char(w, ' ');
+            }
+            writer_char(w, ')');
+            break;
+        }
+        case NODE_VECTOR_LIST: {
+            const VecList* v = (const VecList*)c->car;
+            writer_char(w, '(');
+            for (size_t i = 0; i < v->count; i++) {
+                if (i) writer_char(w, ' ');
+                display_cons(w, v->items[i]);
+            }
+            writer_char(w, ')');
+            break;
+        }
+        case NODE_QUOTE:
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE: {
+            char prefix = (c->type == NODE_QUOTE) ? '\''
+                        : (c->type == NODE_QUASIQUOTE) ? '`'
+                        : ',';
+            writer_char(w, prefix);
+            display_cons(w, *(Cons* const*)c->car);
+            break;
+        }
+        default:
+            writer_str(w, "<unprintable>");
+            break;
+    }
+}
+
+Cons* builtin_display(ConsList* args, Arena** arena) {
+    /* The buffer batches the whole structure into one write (@see
+     * writer.h). It lives on this call's stack — pmap workers may run
+     * display concurrently, so there is no shared Writer to race on;
+     * interleaving is then at worst per display call. */
+    Writer w;
+
+    if (!args) return NULL;
+    if (writer_init(&w, 256) != 0) {
+        fprintf(stderr, "Eval Error: 'display' is out of memory.\n");
+        return NULL;
+    }
+
+    for (const Cons* c = args->head; c; c = c->cdr) {
+        display_cons(&w, c);
+        if (c->cdr) writer_char(&w, ' ');
+    }
+    if (writer_flush(&w, stdout) != 0) {
+        fprintf(stderr, "Eval Error: 'display' failed to write.\n");
+        writer_destroy(&w);
+        return NULL;
+    }
+    writer_destroy(&w);
+    return make_nil(arena);
+}
+
+Cons* builtin_newline(ConsList* args, Arena** arena) {
+    (void)args;
+    fputc('\n', stdout);
+    return make_nil(arena);
+}
+
+/* ------------ Meta ------------ */
+
+/* builtin_apply and builtin_eval live in eval.c: they re-enter the
+ * evaluator. */
+
+Cons* builtin_exit(ConsList* args, Arena** arena) {
+    (void)arena;
+    int code = 0;
+    if (args && args->head && args->head->type == NODE_ATOM_INT)
+        code = (int)cons_as_int(args->head);
+    exit(code);
+}
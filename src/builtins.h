@@ -0,0 +1,84 @@
+/**
+ * @file builtins.h
+ * @brief Built-in function implementations and the dispatch table.
+ *
+ * Each builtin has the uniform builtin_fn signature (@see eval.h) and is
+ * reached through builtin_dispatch_table indexed by BuiltinType, either
+ * from the evaluator or from compiled bytecode (@see vm.h). Name-to-type
+ * resolution goes through the gperf-generated find_builtin.
+ */
+#ifndef BUILTINS_H
+#define BUILTINS_H
+
+#include <stddef.h>
+
+#include "eval.h"
+
+/* ---------------- Name resolution (gperf) ---------------- */
+
+struct BuiltinName {
+    const char* name;
+    BuiltinType type;
+};
+
+/**
+ * @brief Lookup of a builtin by name.
+ *
+ * Probes the gperf perfect hash first, then a small hand-maintained
+ * table of names added since the last regeneration (gperf is not part
+ * of every build environment; @see docs/builtins.gperf).
+ * @return Table entry, or NULL if the name is not a builtin.
+ */
+struct BuiltinName *find_builtin(const char *str, size_t len);
+
+/**
+ * @brief The gperf-generated perfect-hash lookup (find_builtin.c).
+ */
+struct BuiltinName *find_builtin_perfect(register const char *str, register size_t len);
+
+/* ---------------- Dispatch table ---------------- */
+
+/**
+ * @brief BuiltinType-indexed dispatch table, defined in eval.c.
+ */
+extern const builtin_fn builtin_dispatch_table[BUILTIN_COUNT];
+
+/**
+ * @brief BuiltinType-indexed surface names (for printing resolved heads).
+ */
+extern const char* const builtin_type_names[BUILTIN_COUNT];
+
+/* ---------------- Implementations (builtins.c) ---------------- */
+
+Cons* builtin_add(ConsList* args, Arena** arena);
+Cons* builtin_sub(ConsList* args, Arena** arena);
+Cons* builtin_mul(ConsList* args, Arena** arena);
+Cons* builtin_div(ConsList* args, Arena** arena);
+Cons* builtin_mod(ConsList* args, Arena** arena);
+Cons* builtin_num_eq(ConsList* args, Arena** arena);
+Cons* builtin_less_than(ConsList* args, Arena** arena);
+Cons* builtin_greater_than(ConsList* args, Arena** arena);
+Cons* builtin_less_eq(ConsList* args, Arena** arena);
+Cons* builtin_greater_eq(ConsList* args, Arena** arena);
+Cons* builtin_cons(ConsList* args, Arena** arena);
+Cons* builtin_car(ConsList* args, Arena** arena);
+Cons* builtin_cdr(ConsList* args, Arena** arena);
+Cons* builtin_list(ConsList* args, Arena** arena);
+Cons* builtin_is_atom(ConsList* args, Arena** arena);
+Cons* builtin_is_pair(ConsList* args, Arena** arena);
+Cons* builtin_is_list(ConsList* args, Arena** arena);
+Cons* builtin_is_null(ConsList* args, Arena** arena);
+Cons* builtin_is_number(ConsList* args, Arena** arena);
+Cons* builtin_is_string(ConsList* args, Arena** arena);
+Cons* builtin_is_symbol(ConsList* args, Arena** arena);
+Cons* builtin_is_procedure(ConsList* args, Arena** arena);
+Cons* builtin_eq(ConsList* args, Arena** arena);
+Cons* builtin_equal(ConsList* args, Arena** arena);
+Cons* builtin_display(ConsList* args, Arena** arena);
+Cons* builtin_newline(ConsList* args, Arena** arena);
+Cons* builtin_apply(ConsList* args, Arena** arena);
+Cons* builtin_eval(ConsList* args, Arena** arena);
+Cons* builtin_pmap(ConsList* args, Arena** arena);
+Cons* builtin_exit(ConsList* args, Arena** arena);
+
+#endif
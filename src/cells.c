@@ -0,0 +1,57 @@
+/*
+ * @file cells.c
+ */
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "cells.h"
+
+#define N_SMALL_INTS (SMALL_INT_MAX - SMALL_INT_MIN + 1)
+
+/* Per-cell footprint, padded so every cell keeps max_align_t alignment. */
+enum {
+    CELL_STRIDE = (sizeof(Cons) + sizeof(long long) + alignof(max_align_t) - 1)
+                  & ~(size_t)(alignof(max_align_t) - 1)
+};
+
+static _Alignas(max_align_t) unsigned char int_cells[N_SMALL_INTS][CELL_STRIDE];
+static _Alignas(max_align_t) unsigned char nil_cell[sizeof(Cons)];
+static bool cells_ready = false;
+
+static void cells_init(void) {
+    Cons* nil = (Cons*)nil_cell;
+    nil->type = NODE_NIL;
+    nil->cdr = NULL;
+    nil->size = 0;
+
+    for (int i = 0; i < N_SMALL_INTS; i++) {
+        Cons* c = (Cons*)int_cells[i];
+        long long v = SMALL_INT_MIN + i;
+        c->type = NODE_ATOM_INT;
+        c->cdr = NULL;
+        c->size = sizeof(long long);
+        memcpy(c->car, &v, sizeof(v));
+    }
+
+    cells_ready = true;
+}
+
+Cons* cell_nil(void) {
+    if (!cells_ready) cells_init();
+    return (Cons*)nil_cell;
+}
+
+Cons* cell_int(long long v) {
+    if (v < SMALL_INT_MIN || v > SMALL_INT_MAX) return NULL;
+    if (!cells_ready) cells_init();
+    return (Cons*)int_cells[v - SMALL_INT_MIN];
+}
+
+bool cell_is_shared(const Cons* c) {
+    uintptr_t p = (uintptr_t)c;
+    if (p == (uintptr_t)nil_cell) return true;
+    return p >= (uintptr_t)int_cells &&
+           p < (uintptr_t)int_cells + sizeof(int_cells);
+}
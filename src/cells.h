@@ -0,0 +1,53 @@
+/**
+ * @file cells.h
+ * @brief Preallocated immutable cons cells for nil and small integers.
+ *
+ * Numeric-heavy scripts allocate the same tiny values over and over:
+ * nil, 0/1 flags, loop counters, coordinates. The cells here live in
+ * static storage, are built once on first use, and are returned by the
+ * value constructors in builtins.c instead of growing the arena. As a
+ * side effect, eq on two computed small integers is a pointer compare.
+ *
+ * Shared cells are immutable: their cdr stays NULL forever. Callers
+ * that chain values into a list must clone first (the evaluator and the
+ * builtins already do, @see cons_clone_shallow). AST construction keeps
+ * allocating through make_atom because the parser links sibling atoms
+ * through their cdr in place.
+ */
+#ifndef CELLS_H
+#define CELLS_H
+
+#include <stdbool.h>
+
+#include "parser.h"
+
+#define SMALL_INT_MIN (-128)
+#define SMALL_INT_MAX 1023
+
+/**
+ * @brief The shared NODE_NIL cell.
+ */
+Cons* cell_nil(void);
+
+/**
+ * @brief Shared NODE_ATOM_INT cell for v in [SMALL_INT_MIN, SMALL_INT_MAX].
+ * @return The shared cell, or NULL if v is out of range (caller allocates).
+ */
+Cons* cell_int(long long v);
+
+/**
+ * @brief Shared truth cells: integer 1 for true, nil for false.
+ */
+static inline Cons* cell_bool(bool b) {
+    return b ? cell_int(1) : cell_nil();
+}
+
+/**
+ * @brief True if c points into the static cell pool.
+ *
+ * Pool cells have process lifetime: copy-out machinery (arena promotion,
+ * image writing) can keep the pointer instead of cloning.
+ */
+bool cell_is_shared(const Cons* c);
+
+#endif
@@ -1,42 +1,33 @@
 /*
  * @file eval.c
+ * @brief Explicit-stack expression evaluator with tail-call elimination.
+ *
+ * Evaluation is driven by a loop over a frame stack instead of C
+ * recursion. Every pending piece of work (an unevaluated expression, an
+ * if waiting on its condition, a call collecting its operands, ...) is a
+ * Frame; the driver pops one frame at a time and the last computed value
+ * travels in a single result register. Tail positions push no frame on
+ * top of the work they replace, so tail-recursive loops run at a bounded
+ * stack depth, and deeply nested non-tail recursion grows the
+ * arena-backed stack instead of smashing the C stack.
  */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
 #include "eval.h"
 #include "builtins.h"
+#include "cells.h"
 #include "parser.h"
+#include "passes.h"
+#include "symtab.h"
+#include "intern.h"
+#include "stats.h"
 
 
-Cons* builtin_add(ConsList* args, Arena** arena);
-Cons* builtin_sub(ConsList* args, Arena** arena);
-Cons* builtin_mul(ConsList* args, Arena** arena);
-Cons* builtin_div(ConsList* args, Arena** arena);
-Cons* builtin_mod(ConsList* args, Arena** arena);
-Cons* builtin_num_eq(ConsList* args, Arena** arena);
-Cons* builtin_less_than(ConsList* args, Arena** arena);
-Cons* builtin_greater_than(ConsList* args, Arena** arena);
-Cons* builtin_less_eq(ConsList* args, Arena** arena);
-Cons* builtin_greater_eq(ConsList* args, Arena** arena);
-Cons* builtin_cons(ConsList* args, Arena** arena);
-Cons* builtin_car(ConsList* args, Arena** arena);
-Cons* builtin_cdr(ConsList* args, Arena** arena);
-Cons* builtin_list(ConsList* args, Arena** arena);
-Cons* builtin_is_atom(ConsList* args, Arena** arena);
-Cons* builtin_is_pair(ConsList* args, Arena** arena);
-Cons* builtin_is_list(ConsList* args, Arena** arena);
-Cons* builtin_is_null(ConsList* args, Arena** arena);
-Cons* builtin_is_number(ConsList* args, Arena** arena);
-Cons* builtin_is_string(ConsList* args, Arena** arena);
-Cons* builtin_is_symbol(ConsList* args, Arena** arena);
-Cons* builtin_is_procedure(ConsList* args, Arena** arena);
-Cons* builtin_eq(ConsList* args, Arena** arena);
-Cons* builtin_equal(ConsList* args, Arena** arena);
-Cons* builtin_display(ConsList* args, Arena** arena);
-Cons* builtin_newline(ConsList* args, Arena** arena);
-Cons* builtin_apply(ConsList* args, Arena** arena);
-Cons* builtin_eval(ConsList* args, Arena** arena);
-Cons* builtin_exit(ConsList* args, Arena** arena);
-
-static const builtin_fn builtin_dispatch_table[] = {
+const builtin_fn builtin_dispatch_table[BUILTIN_COUNT] = {
     [BUILTIN_ADD]           = builtin_add,
     [BUILTIN_SUB]           = builtin_sub,
     [BUILTIN_MUL]           = builtin_mul,
@@ -66,4 +57,1332 @@ static const builtin_fn builtin_dispatch_table[] = {
     [BUILTIN_APPLY]         = builtin_apply,
     [BUILTIN_EVAL]          = builtin_eval,
     [BUILTIN_EXIT]          = builtin_exit,
+    [BUILTIN_PMAP]          = builtin_pmap,
+};
+
+/* Surface names, for printing resolved NODE_BUILTIN heads. */
+const char* const builtin_type_names[BUILTIN_COUNT] = {
+    [BUILTIN_ADD]           = "+",
+    [BUILTIN_SUB]           = "-",
+    [BUILTIN_MUL]           = "*",
+    [BUILTIN_DIV]           = "/",
+    [BUILTIN_MOD]           = "mod",
+    [BUILTIN_NUM_EQ]        = "=",
+    [BUILTIN_LESS_THAN]     = "<",
+    [BUILTIN_GREATER_THAN]  = ">",
+    [BUILTIN_LESS_EQ]       = "<=",
+    [BUILTIN_GREATER_EQ]    = ">=",
+    [BUILTIN_CONS]          = "cons",
+    [BUILTIN_CAR]           = "car",
+    [BUILTIN_CDR]           = "cdr",
+    [BUILTIN_LIST]          = "list",
+    [BUILTIN_IS_ATOM]       = "atom?",
+    [BUILTIN_IS_PAIR]       = "pair?",
+    [BUILTIN_IS_LIST]       = "list?",
+    [BUILTIN_IS_NULL]       = "null?",
+    [BUILTIN_IS_NUMBER]     = "number?",
+    [BUILTIN_IS_STRING]     = "string?",
+    [BUILTIN_IS_SYMBOL]     = "symbol?",
+    [BUILTIN_IS_PROCEDURE]  = "procedure?",
+    [BUILTIN_EQ]            = "eq?",
+    [BUILTIN_EQUAL]         = "equal?",
+    [BUILTIN_DISPLAY]       = "display",
+    [BUILTIN_NEWLINE]       = "newline",
+    [BUILTIN_APPLY]         = "apply",
+    [BUILTIN_EVAL]          = "eval",
+    [BUILTIN_EXIT]          = "exit",
+    [BUILTIN_PMAP]          = "pmap",
 };
+
+/* ------------------ Special forms ------------------ */
+
+/*
+ * Special form heads are recognized by interned ID, not by strcmp: the
+ * refs below are interned once against the same pool the parser used, so
+ * the hot dispatch in the driver is an integer compare.
+ */
+static SymRef sf_quote, sf_if, sf_define, sf_set, sf_lambda, sf_begin;
+static bool sf_ready = false;
+
+static int special_forms_init(void) {
+    if (sf_ready) return 0;
+
+    if (intern_ref(&sf_quote,  "quote",  5) != 0 ||
+        intern_ref(&sf_if,     "if",     2) != 0 ||
+        intern_ref(&sf_define, "define", 6) != 0 ||
+        intern_ref(&sf_set,    "set!",   4) != 0 ||
+        intern_ref(&sf_lambda, "lambda", 6) != 0 ||
+        intern_ref(&sf_begin,  "begin",  5) != 0) {
+        return -1;
+    }
+
+    sf_ready = true;
+    return 0;
+}
+
+/* ------------------ Frames ------------------ */
+
+typedef enum FrameKind : uint8_t {
+    F_EVAL,     ///< Evaluate expr in env
+    F_IF,       ///< Result register holds the condition; pick a branch
+    F_SEQ,      ///< Evaluate a body chain; the last form is a tail position
+    F_DEFINE,   ///< Result register holds the value; bind ref
+    F_SET,      ///< Result register holds the value; assign ref
+    F_ARGS      ///< Collect evaluated operator + operands, then apply
+} FrameKind;
+
+typedef struct Frame {
+    FrameKind kind;
+    Cons* expr;             ///< F_EVAL: expression to evaluate
+    Cons* pending;          ///< F_IF: then / F_SEQ: next form / F_ARGS: next operand
+    Cons* alt;              ///< F_IF: else branch (may be NULL)
+    Symtab* env;
+    ActRec* act;            ///< Current activation record (may be NULL)
+    ConsList* acc;          ///< F_ARGS: evaluated (op arg...) so far
+    const SymRef* ref;      ///< F_DEFINE / F_SET target (NULL: expr is a local)
+} Frame;
+
+/*
+ * Growable frame stack in the arena (same pattern as the VM value
+ * stack): overflow from pathological nesting surfaces as an allocation
+ * failure and a clean error, never a segfault.
+ */
+typedef struct FrameStack {
+    Frame* base;
+    size_t len;
+    size_t cap;
+} FrameStack;
+
+#define EVAL_STACK_INITIAL 64
+
+static int frames_push(FrameStack* s, Frame f, Arena** arena) {
+    if (s->len == s->cap) {
+        size_t new_cap = s->cap * 2;
+        Frame* nb = (Frame*)arena_alloc(arena, new_cap * sizeof(Frame));
+        if (!nb) {
+            fprintf(stderr, "Eval Error: evaluation stack overflow.\n");
+            return -1;
+        }
+        memcpy(nb, s->base, s->len * sizeof(Frame));
+        s->base = nb;
+        s->cap = new_cap;
+    }
+    s->base[s->len++] = f;
+    return 0;
+}
+
+/* ------------------ Helpers ------------------ */
+
+static bool cons_is_truthy(const Cons* c) {
+    return c && c->type != NODE_NIL;
+}
+
+/* Global scope of the running program, for builtin_eval/builtin_apply. */
+static Symtab* g_global_env = NULL;
+
+/* ------------------ Inline cache for global reads ------------------ */
+
+/*
+ * Steady-state global reads skip the Robin Hood probe entirely: interned
+ * IDs are dense, so a flat array indexed by SymRef id gives one cache
+ * slot per distinct name (a NODE_ATOM_SYM cell carries a fixed SymRef
+ * payload and has no room for a per-site slot). An entry is trusted only
+ * while its generation matches symtab_generation — any define or rehash
+ * bumps that and every entry lazily re-resolves. The cache is consulted
+ * only for lookups starting at the global scope; reads from child scopes
+ * may hit a shadowing binding and must still walk the chain.
+ */
+typedef struct SymCacheEntry {
+    Symbol* sym;
+    uint64_t gen;               /* 0 = never filled (generation starts at 1) */
+} SymCacheEntry;
+
+static SymCacheEntry* g_sym_cache = NULL;
+static size_t g_sym_cache_len = 0;
+static const Symtab* g_sym_cache_env = NULL;
+
+/* Set for the duration of a parallel map (@see builtin_pmap): the cache
+ * array is single-threaded state, so workers take the probe path. */
+static bool g_eval_parallel = false;
+
+static Symbol* sym_cache_lookup(const Symtab* env, const SymRef* ref) {
+    if (g_eval_parallel) return symtab_lookup_ref(env, ref);
+
+    if (env != g_sym_cache_env) {
+        /* A different globals table (nested eval_program, REPL vs
+         * script): generations do not distinguish tables, so drop
+         * everything filled against the old one. */
+        memset(g_sym_cache, 0, g_sym_cache_len * sizeof(SymCacheEntry));
+        g_sym_cache_env = env;
+    }
+
+    if (ref->id < g_sym_cache_len) {
+        SymCacheEntry* e = &g_sym_cache[ref->id];
+        if (e->gen == symtab_generation) return e->sym;
+    }
+
+    Symbol* sym = symtab_lookup_ref(env, ref);
+    if (!sym) return NULL;
+
+    if (ref->id >= g_sym_cache_len) {
+        size_t new_len = g_sym_cache_len ? g_sym_cache_len * 2 : 256;
+        while (new_len <= ref->id) new_len *= 2;
+        SymCacheEntry* nb = realloc(g_sym_cache,
+                                    new_len * sizeof(SymCacheEntry));
+        if (!nb) return sym;    /* the cache is only an accelerator */
+        memset(nb + g_sym_cache_len, 0,
+               (new_len - g_sym_cache_len) * sizeof(SymCacheEntry));
+        g_sym_cache = nb;
+        g_sym_cache_len = new_len;
+    }
+
+    g_sym_cache[ref->id] = (SymCacheEntry){ .sym = sym,
+                                            .gen = symtab_generation };
+    return sym;
+}
+
+/*
+ * Bind a lambda's parameters to evaluated arguments. The hot path is a
+ * flat activation record: one bump allocation, arguments copied into
+ * slots, *env_out aliasing the captured scope directly. Only bodies
+ * with internal defines pay for a child Symtab (and get their
+ * parameters bound in it, since the locals pass left their references
+ * as symbols).
+ */
+static ActRec* lambda_bind(const Lambda* lam, ConsList* args,
+                           Symtab** env_out, Arena** arena) {
+    if (lam->params->length != args->length) {
+        fprintf(stderr, "Eval Error: lambda expects %zu argument(s), got %zu.\n",
+                lam->params->length, args->length);
+        return NULL;
+    }
+
+    ActRec* rec = (ActRec*)arena_alloc(arena, sizeof(ActRec));
+    if (!rec) return NULL;
+    rec->up = lam->act;
+    rec->count = lam->params->length + lam->cap_count;
+    rec->arena = arena;
+    rec->slots = NULL;
+    if (rec->count) {
+        rec->slots = (Cons**)arena_alloc(arena, rec->count * sizeof(Cons*));
+        if (!rec->slots) return NULL;
+        size_t i = 0;
+        for (Cons* a = args->head; a; a = a->cdr) rec->slots[i++] = a;
+        /* Captured values sit after the parameters, where the locals
+         * pass pointed their depth-0 references (@see LambdaSig). */
+        for (uint32_t k = 0; k < lam->cap_count; k++) {
+            rec->slots[i++] = lam->caps[k];
+        }
+    }
+
+    if (!lam->has_defines) {
+        *env_out = lam->env;
+        return rec;
+    }
+
+    Symtab* frame_env = symtab_new(lam->env, arena);
+    if (!frame_env) return NULL;
+
+    Cons* p = lam->params->head;
+    Cons* a = args->head;
+    for (; p && a; p = p->cdr, a = a->cdr) {
+        if (!symtab_define_ref(frame_env, (const SymRef*)p->car, a, false)) {
+            return NULL;
+        }
+    }
+    *env_out = frame_env;
+    return rec;
+}
+
+/* ------------------ Escape promotion ------------------ */
+
+/*
+ * Evaluation temporaries live in a scratch arena that eval_program
+ * bulk-resets after every top-level form. Anything that escapes into a
+ * persistent scope (a define/set! whose target symtab lives in another
+ * arena) is deep-copied out first. A pointer memo keeps shared structure
+ * shared and makes self-referential closures terminate; it is malloc'd
+ * because promotion is a cold path that ends with the scratch reset.
+ */
+typedef struct PromoMap {
+    const void** keys;
+    void** vals;
+    size_t size;        /* power of two */
+    size_t count;
+} PromoMap;
+
+static void* promo_get(const PromoMap* m, const void* key) {
+    if (!m->size) return NULL;
+    size_t mask = m->size - 1;
+    for (size_t i = ((uintptr_t)key >> 4) & mask; m->keys[i]; i = (i + 1) & mask) {
+        if (m->keys[i] == key) return m->vals[i];
+    }
+    return NULL;
+}
+
+static int promo_put(PromoMap* m, const void* key, void* val) {
+    if (m->count * 4 >= m->size * 3) {
+        size_t new_size = m->size ? m->size * 2 : 64;
+        const void** nk = calloc(new_size, sizeof(void*));
+        void** nv = calloc(new_size, sizeof(void*));
+        if (!nk || !nv) { free(nk); free(nv); return -1; }
+        for (size_t i = 0; i < m->size; i++) {
+            if (!m->keys[i]) continue;
+            size_t mask = new_size - 1;
+            size_t j = ((uintptr_t)m->keys[i] >> 4) & mask;
+            while (nk[j]) j = (j + 1) & mask;
+            nk[j] = m->keys[i];
+            nv[j] = m->vals[i];
+        }
+        free(m->keys);
+        free(m->vals);
+        m->keys = nk;
+        m->vals = nv;
+        m->size = new_size;
+    }
+    size_t mask = m->size - 1;
+    size_t i = ((uintptr_t)key >> 4) & mask;
+    while (m->keys[i]) i = (i + 1) & mask;
+    m->keys[i] = key;
+    m->vals[i] = val;
+    m->count++;
+    return 0;
+}
+
+static Cons* promote_cons(Cons* v, Arena** dst, PromoMap* m);
+static ConsList* promote_list(ConsList* l, Arena** dst, PromoMap* m);
+static Symtab* promote_env(Symtab* env, Arena** dst, PromoMap* m);
+static ActRec* promote_act(ActRec* rec, Arena** dst, PromoMap* m);
+
+/* Copy a cdr-linked chain (lambda body, list elements) preserving links. */
+static Cons* promote_chain(Cons* head, Arena** dst, PromoMap* m) {
+    Cons* first = NULL;
+    Cons* prev = NULL;
+    for (Cons* cur = head; cur; cur = cur->cdr) {
+        Cons* copy = promote_cons(cur, dst, m);
+        if (!copy) return NULL;
+        if (prev) prev->cdr = copy;
+        else first = copy;
+        prev = copy;
+    }
+    return first;
+}
+
+static Cons* promote_cons(Cons* v, Arena** dst, PromoMap* m) {
+    if (!v) return NULL;
+    if (cell_is_shared(v)) return v;
+
+    Cons* hit = (Cons*)promo_get(m, v);
+    if (hit) return hit;
+
+    Cons* c = (Cons*)arena_alloc(dst, sizeof(Cons) + v->size);
+    if (!c) return NULL;
+    memcpy(c, v, sizeof(Cons) + v->size);
+    c->cdr = NULL;
+    /* Memoize before recursing so cycles resolve to this copy. */
+    if (promo_put(m, v, c) != 0) return NULL;
+
+    switch (v->type) {
+        case NODE_LIST: {
+            ConsList* sub = *(ConsList**)v->car;
+            if (sub) {
+                ConsList* nsub = promote_list(sub, dst, m);
+                if (!nsub) return NULL;
+                *(ConsList**)c->car = nsub;
+            }
+            break;
+        }
+
+        case NODE_QUOTE:
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE: {
+            Cons* inner = *(Cons**)v->car;
+            if (inner) {
+                Cons* ninner = promote_cons(inner, dst, m);
+                if (!ninner) return NULL;
+                *(Cons**)c->car = ninner;
+            }
+            break;
+        }
+
+        case NODE_VECTOR_LIST: {
+            VecList* vl = (VecList*)c->car;
+            if (vl->count) {
+                Cons** items = (Cons**)arena_alloc(dst, vl->count * sizeof(Cons*));
+                if (!items) return NULL;
+                for (size_t i = 0; i < vl->count; i++) {
+                    items[i] = promote_cons(vl->items[i], dst, m);
+                    if (!items[i]) return NULL;
+                }
+                vl->items = items;
+            }
+            break;
+        }
+
+        case NODE_ATOM_STR: {
+            /* One block: header and bytes travel together. */
+            const WispStr* s = *(WispStr* const*)v->car;
+            size_t n = sizeof(WispStr) + s->len + 1;
+            WispStr* ns = (WispStr*)arena_alloc(dst, n);
+            if (!ns) return NULL;
+            memcpy(ns, s, n);
+            *(WispStr**)c->car = ns;
+            break;
+        }
+
+        case NODE_ATOM_UNINTERNED: {
+            const char* s = *(char* const*)v->car;
+            size_t n = strlen(s) + 1;
+            char* ns = (char*)arena_alloc(dst, n);
+            if (!ns) return NULL;
+            memcpy(ns, s, n);
+            *(char**)c->car = ns;
+            break;
+        }
+
+        case NODE_LAMBDA: {
+            Lambda* lam = (Lambda*)c->car;
+            lam->params = promote_list(lam->params, dst, m);
+            if (!lam->params) return NULL;
+            lam->body = promote_chain(lam->body, dst, m);
+            if (!lam->body) return NULL;
+            lam->env = promote_env(lam->env, dst, m);
+            if (!lam->env) return NULL;
+            if (lam->act) {
+                lam->act = promote_act(lam->act, dst, m);
+                if (!lam->act) return NULL;
+            }
+            if (lam->cap_count) {
+                Cons** nc = (Cons**)arena_alloc(dst,
+                                                lam->cap_count * sizeof(Cons*));
+                if (!nc) return NULL;
+                for (uint32_t i = 0; i < lam->cap_count; i++) {
+                    nc[i] = promote_cons(lam->caps[i], dst, m);
+                    if (!nc[i]) return NULL;
+                }
+                lam->caps = nc;
+            }
+            break;
+        }
+
+        default:
+            /* Ints, floats, nil: self-contained. Symbols: the SymRef
+             * name is owned by the intern pool, which is persistent. */
+            break;
+    }
+
+    return c;
+}
+
+static ConsList* promote_list(ConsList* l, Arena** dst, PromoMap* m) {
+    ConsList* hit = (ConsList*)promo_get(m, l);
+    if (hit) return hit;
+
+    ConsList* nl = (ConsList*)arena_alloc(dst, sizeof(ConsList));
+    if (!nl) return NULL;
+    if (promo_put(m, l, nl) != 0) return NULL;
+
+    nl->head = promote_chain(l->head, dst, m);
+    if (l->head && !nl->head) return NULL;
+    nl->length = l->length;
+    nl->tail = nl->head;
+    while (nl->tail && nl->tail->cdr) nl->tail = nl->tail->cdr;
+    return nl;
+}
+
+static Symtab* promote_env(Symtab* env, Arena** dst, PromoMap* m) {
+    if (!env) return NULL;
+    if (env->arena == dst) return env;    /* already persistent */
+
+    Symtab* hit = (Symtab*)promo_get(m, env);
+    if (hit) return hit;
+
+    Symtab* st = (Symtab*)arena_alloc(dst, sizeof(Symtab));
+    if (!st) return NULL;
+    if (promo_put(m, env, st) != 0) return NULL;
+
+    st->arena = dst;
+    st->size = env->size;
+    st->count = env->count;
+    st->slots = (Symbol*)arena_alloc(dst, sizeof(Symbol) * env->size);
+    st->hashes = (uint32_t*)arena_alloc(dst, sizeof(uint32_t) * env->size);
+    if (!st->slots || !st->hashes) return NULL;
+    memcpy(st->slots, env->slots, sizeof(Symbol) * env->size);
+    memcpy(st->hashes, env->hashes, sizeof(uint32_t) * env->size);
+
+    st->parent = env->parent ? promote_env(env->parent, dst, m) : NULL;
+    if (env->parent && !st->parent) return NULL;
+
+    /* Names are canonical intern-pool pointers (the evaluator binds only
+     * through symtab_define_ref); the values must move with the scope. */
+    for (size_t i = 0; i < st->size; i++) {
+        if (!st->slots[i].name || !st->slots[i].value) continue;
+        st->slots[i].value = promote_cons(st->slots[i].value, dst, m);
+        if (!st->slots[i].value) return NULL;
+    }
+    return st;
+}
+
+static ActRec* promote_act(ActRec* rec, Arena** dst, PromoMap* m) {
+    if (!rec) return NULL;
+    if (rec->arena == dst) return rec;    /* already persistent */
+
+    ActRec* hit = (ActRec*)promo_get(m, rec);
+    if (hit) return hit;
+
+    ActRec* nr = (ActRec*)arena_alloc(dst, sizeof(ActRec));
+    if (!nr) return NULL;
+    if (promo_put(m, rec, nr) != 0) return NULL;
+
+    nr->count = rec->count;
+    nr->arena = dst;
+    nr->slots = NULL;
+    if (nr->count) {
+        nr->slots = (Cons**)arena_alloc(dst, nr->count * sizeof(Cons*));
+        if (!nr->slots) return NULL;
+        for (size_t i = 0; i < nr->count; i++) {
+            nr->slots[i] = promote_cons(rec->slots[i], dst, m);
+            if (!nr->slots[i]) return NULL;
+        }
+    }
+
+    nr->up = rec->up ? promote_act(rec->up, dst, m) : NULL;
+    if (rec->up && !nr->up) return NULL;
+    return nr;
+}
+
+/*
+ * Deep-copy a value out of the scratch arena into dst. Used when a
+ * define/set! target scope outlives the current top-level form.
+ */
+static Cons* promote_value(Cons* v, Arena** dst) {
+    if (!v || cell_is_shared(v)) return v;
+    PromoMap m = { 0 };
+    Cons* result = promote_cons(v, dst, &m);
+    free(m.keys);
+    free(m.vals);
+    return result;
+}
+
+static Cons* make_lambda(ConsList* params, Cons* body, Symtab* env,
+                         ActRec* act, Cons** caps, uint32_t cap_count,
+                         Arena** arena) {
+    if (!body) {
+        fprintf(stderr, "Eval Error: lambda body is empty.\n");
+        return NULL;
+    }
+    for (const Cons* p = params->head; p; p = p->cdr) {
+        if (p->type != NODE_ATOM_SYM) {
+            fprintf(stderr, "Eval Error: lambda parameter is not a symbol.\n");
+            return NULL;
+        }
+    }
+    Lambda lam = { .params = params, .body = body, .env = env, .act = act,
+                   .caps = caps, .cap_count = cap_count,
+                   .has_defines = lambda_body_has_define(body) };
+    return make_atom(&lam, sizeof(lam), NODE_LAMBDA, arena);
+}
+
+/* ------------------ Driver ------------------ */
+
+static Cons* eval_run(Cons* expr, Symtab* env, ActRec* act, Arena** arena) {
+    if (!expr || !env || !arena || !*arena) return NULL;
+    if (special_forms_init() != 0) return NULL;
+
+    FrameStack stack = {
+        .base = (Frame*)arena_alloc(arena, EVAL_STACK_INITIAL * sizeof(Frame)),
+        .len = 0,
+        .cap = EVAL_STACK_INITIAL,
+    };
+    if (!stack.base) return NULL;
+
+    Cons* reg = NULL;
+
+    if (frames_push(&stack, (Frame){ .kind = F_EVAL, .expr = expr, .env = env,
+                    .act = act }, arena) != 0) {
+        return NULL;
+    }
+
+    while (stack.len > 0) {
+        Frame f = stack.base[--stack.len];
+
+        switch (f.kind) {
+
+        case F_EVAL: {
+            Cons* e = f.expr;
+            switch (e->type) {
+
+            case NODE_ATOM_INT:
+            case NODE_ATOM_FLOAT:
+            case NODE_ATOM_STR:
+            case NODE_ATOM_UNINTERNED:
+            case NODE_NIL:
+            case NODE_LAMBDA:
+            case NODE_BUILTIN:
+            case NODE_VECTOR_LIST:
+                reg = e;
+                break;
+
+            case NODE_LOCAL_REF: {
+                /* Two adds and a load: depth records up, slot entries in. */
+                const LocalRef* lr = (const LocalRef*)e->car;
+                ActRec* rec = f.act;
+                for (uint32_t d = lr->depth; rec && d; d--) rec = rec->up;
+                if (!rec || lr->slot >= rec->count) {
+                    fprintf(stderr, "Eval Error: unresolved local '%s'.\n",
+                            lr->name);
+                    return NULL;
+                }
+                reg = rec->slots[lr->slot];
+                break;
+            }
+
+            case NODE_ATOM_SYM: {
+                const SymRef* ref = (const SymRef*)e->car;
+                Symbol* sym = symtab_is_global(f.env)
+                                  ? sym_cache_lookup(f.env, ref)
+                                  : symtab_lookup_ref(f.env, ref);
+                if (sym) {
+                    reg = sym->value;
+                    break;
+                }
+                /* A bare builtin name denotes itself (see apply). */
+                if (find_builtin(ref->name, strlen(ref->name))) {
+                    reg = e;
+                    break;
+                }
+                fprintf(stderr, "Eval Error: unbound symbol '%s'.\n", ref->name);
+                return NULL;
+            }
+
+            case NODE_QUOTE:
+                reg = *(Cons**)e->car;
+                break;
+
+            case NODE_QUASIQUOTE:
+            case NODE_UNQUOTE:
+                /* Templates are expanded at parse time (@see
+                 * expand_quasiquote); anything still here is data. */
+                reg = *(Cons**)e->car;
+                break;
+
+            case NODE_LIST: {
+                ConsList* form = *(ConsList**)e->car;
+                if (!form || !form->head) {
+                    reg = e;    /* () is self-evaluating */
+                    break;
+                }
+
+                Cons* head = form->head;
+                if (head->type == NODE_ATOM_SYM) {
+                    const SymRef* ref = (const SymRef*)head->car;
+
+                    if (sym_ref_eq(ref, &sf_quote)) {
+                        if (!head->cdr) {
+                            fprintf(stderr, "Eval Error: 'quote' expects one form.\n");
+                            return NULL;
+                        }
+                        reg = head->cdr;
+                        break;
+                    }
+
+                    if (sym_ref_eq(ref, &sf_if)) {
+                        Cons* cond = head->cdr;
+                        Cons* then_b = cond ? cond->cdr : NULL;
+                        if (!cond || !then_b) {
+                            fprintf(stderr, "Eval Error: 'if' expects a condition and a branch.\n");
+                            return NULL;
+                        }
+                        /* Branches are tail positions: F_IF replaces this frame. */
+                        if (frames_push(&stack, (Frame){ .kind = F_IF,
+                                        .pending = then_b, .alt = then_b->cdr,
+                                        .env = f.env, .act = f.act }, arena) != 0 ||
+                            frames_push(&stack, (Frame){ .kind = F_EVAL,
+                                        .expr = cond, .env = f.env,
+                                        .act = f.act }, arena) != 0) {
+                            return NULL;
+                        }
+                        break;
+                    }
+
+                    if (sym_ref_eq(ref, &sf_define)) {
+                        Cons* target = head->cdr;
+                        if (!target) {
+                            fprintf(stderr, "Eval Error: 'define' expects a name.\n");
+                            return NULL;
+                        }
+
+                        if (target->type == NODE_ATOM_SYM) {
+                            Cons* value = target->cdr;
+                            if (!value) {
+                                fprintf(stderr, "Eval Error: 'define' expects a value.\n");
+                                return NULL;
+                            }
+                            if (frames_push(&stack, (Frame){ .kind = F_DEFINE,
+                                            .ref = (const SymRef*)target->car,
+                                            .env = f.env, .act = f.act }, arena) != 0 ||
+                                frames_push(&stack, (Frame){ .kind = F_EVAL,
+                                            .expr = value, .env = f.env,
+                                            .act = f.act }, arena) != 0) {
+                                return NULL;
+                            }
+                            break;
+                        }
+
+                        /* (define (f a b) body...) procedure shorthand. */
+                        if (target->type == NODE_LIST) {
+                            ConsList* sig = *(ConsList**)target->car;
+                            if (!sig || !sig->head || sig->head->type != NODE_ATOM_SYM) {
+                                fprintf(stderr, "Eval Error: malformed 'define' signature.\n");
+                                return NULL;
+                            }
+                            ConsList* params = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+                            if (!params) return NULL;
+                            params->head = sig->head->cdr;
+                            params->tail = sig->head->cdr ? sig->tail : NULL;
+                            params->length = sig->length - 1;
+
+                            Cons* lam = make_lambda(params, target->cdr, f.env,
+                                                    f.act, NULL, 0, arena);
+                            if (!lam) return NULL;
+                            if (f.env->arena != arena) {
+                                lam = promote_value(lam, f.env->arena);
+                                if (!lam) return NULL;
+                            }
+                            if (!symtab_define_ref(f.env, (const SymRef*)sig->head->car,
+                                                   lam, false)) {
+                                fprintf(stderr, "Eval Error: cannot redefine constant '%s'.\n",
+                                        ((const SymRef*)sig->head->car)->name);
+                                return NULL;
+                            }
+                            reg = lam;
+                            break;
+                        }
+
+                        fprintf(stderr, "Eval Error: 'define' target must be a symbol or a signature.\n");
+                        return NULL;
+                    }
+
+                    if (sym_ref_eq(ref, &sf_set)) {
+                        Cons* target = head->cdr;
+                        Cons* value = target ? target->cdr : NULL;
+                        if (!target || !value ||
+                            (target->type != NODE_ATOM_SYM &&
+                             target->type != NODE_LOCAL_REF)) {
+                            fprintf(stderr, "Eval Error: 'set!' expects a symbol and a value.\n");
+                            return NULL;
+                        }
+                        /* Slot-resolved targets ride in expr; ref stays
+                         * NULL and F_SET writes the record directly. */
+                        if (frames_push(&stack, (Frame){ .kind = F_SET,
+                                        .ref = target->type == NODE_ATOM_SYM
+                                             ? (const SymRef*)target->car : NULL,
+                                        .expr = target,
+                                        .env = f.env, .act = f.act }, arena) != 0 ||
+                            frames_push(&stack, (Frame){ .kind = F_EVAL,
+                                        .expr = value, .env = f.env,
+                                        .act = f.act }, arena) != 0) {
+                            return NULL;
+                        }
+                        break;
+                    }
+
+                    if (sym_ref_eq(ref, &sf_lambda)) {
+                        Cons* params_node = head->cdr;
+                        ConsList* params = NULL;
+                        Cons** caps = NULL;
+                        uint32_t cap_count = 0;
+
+                        if (params_node &&
+                            params_node->type == NODE_LAMBDA_SIG) {
+                            /* Capture plan from the locals pass:
+                             * materialize each captured value out of the
+                             * creating frame's record chain, once. */
+                            const LambdaSig* sig =
+                                *(const LambdaSig* const*)params_node->car;
+                            params = sig->params;
+                            cap_count = sig->cap_count;
+                            caps = (Cons**)arena_alloc(arena,
+                                        cap_count * sizeof(Cons*));
+                            if (!caps) return NULL;
+                            for (uint32_t i = 0; i < cap_count; i++) {
+                                ActRec* rec = f.act;
+                                for (uint32_t d = sig->caps[i].depth;
+                                     rec && d; d--) {
+                                    rec = rec->up;
+                                }
+                                if (!rec || sig->caps[i].slot >= rec->count) {
+                                    fprintf(stderr, "Eval Error: unresolved capture in 'lambda'.\n");
+                                    return NULL;
+                                }
+                                caps[i] = rec->slots[sig->caps[i].slot];
+                            }
+                        } else if (params_node &&
+                                   params_node->type == NODE_LIST) {
+                            params = *(ConsList**)params_node->car;
+                        } else {
+                            fprintf(stderr, "Eval Error: 'lambda' expects a parameter list.\n");
+                            return NULL;
+                        }
+
+                        Cons* lam = make_lambda(params, params_node->cdr,
+                                                f.env, f.act, caps,
+                                                cap_count, arena);
+                        if (!lam) return NULL;
+                        reg = lam;
+                        break;
+                    }
+
+                    if (sym_ref_eq(ref, &sf_begin)) {
+                        if (!head->cdr) {
+                            reg = cell_nil();
+                            break;
+                        }
+                        if (frames_push(&stack, (Frame){ .kind = F_SEQ,
+                                        .pending = head->cdr, .env = f.env,
+                                        .act = f.act }, arena) != 0) {
+                            return NULL;
+                        }
+                        break;
+                    }
+                }
+
+                /* Plain call: collect operator and operands left to right. */
+                if (frames_push(&stack, (Frame){ .kind = F_ARGS,
+                                .pending = head, .env = f.env,
+                                .act = f.act }, arena) != 0) {
+                    return NULL;
+                }
+                break;
+            }
+
+            default:
+                fprintf(stderr, "Eval Error: cannot evaluate node type %d.\n", e->type);
+                return NULL;
+            }
+            break;
+        }
+
+        case F_IF: {
+            Cons* branch = cons_is_truthy(reg) ? f.pending : f.alt;
+            if (!branch) {
+                reg = cell_nil();
+                break;
+            }
+            if (frames_push(&stack, (Frame){ .kind = F_EVAL,
+                            .expr = branch, .env = f.env,
+                            .act = f.act }, arena) != 0) {
+                return NULL;
+            }
+            break;
+        }
+
+        case F_SEQ: {
+            Cons* form = f.pending;
+            if (!form) {
+                reg = cell_nil();
+                break;
+            }
+            /* The last form runs without a continuation: tail position. */
+            if (form->cdr) {
+                if (frames_push(&stack, (Frame){ .kind = F_SEQ,
+                                .pending = form->cdr, .env = f.env,
+                                .act = f.act }, arena) != 0) {
+                    return NULL;
+                }
+            }
+            if (frames_push(&stack, (Frame){ .kind = F_EVAL,
+                            .expr = form, .env = f.env,
+                            .act = f.act }, arena) != 0) {
+                return NULL;
+            }
+            break;
+        }
+
+        case F_DEFINE: {
+            if (f.env->arena != arena) {
+                reg = promote_value(reg, f.env->arena);
+                if (!reg) return NULL;
+            }
+            if (!symtab_define_ref(f.env, f.ref, reg, false)) {
+                fprintf(stderr, "Eval Error: cannot redefine constant '%s'.\n",
+                        f.ref->name);
+                return NULL;
+            }
+            break;
+        }
+
+        case F_SET: {
+            if (!f.ref) {
+                /* Slot-resolved parameter: write the activation record. */
+                const LocalRef* lr = (const LocalRef*)f.expr->car;
+                ActRec* rec = f.act;
+                for (uint32_t d = lr->depth; rec && d; d--) rec = rec->up;
+                if (!rec || lr->slot >= rec->count) {
+                    fprintf(stderr, "Eval Error: unresolved local '%s'.\n",
+                            lr->name);
+                    return NULL;
+                }
+                if (rec->arena != arena) {
+                    reg = promote_value(reg, rec->arena);
+                    if (!reg) return NULL;
+                }
+                rec->slots[lr->slot] = reg;
+                break;
+            }
+
+            /* Find the owning scope: promotion depends on where the
+             * binding lives, not on where the set! runs. */
+            Symtab* owner = f.env;
+            Symbol* sym = NULL;
+            while (owner && !(sym = symtab_lookup_local_ref(owner, f.ref))) {
+                owner = owner->parent;
+            }
+            if (!sym) {
+                fprintf(stderr, "Eval Error: 'set!' on unbound symbol '%s'.\n",
+                        f.ref->name);
+                return NULL;
+            }
+            if (sym->is_const) {
+                fprintf(stderr, "Eval Error: 'set!' on constant '%s'.\n",
+                        f.ref->name);
+                return NULL;
+            }
+            if (owner->arena != arena) {
+                reg = promote_value(reg, owner->arena);
+                if (!reg) return NULL;
+            }
+            sym->value = reg;
+            break;
+        }
+
+        case F_ARGS: {
+            if (!f.acc) {
+                f.acc = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+                if (!f.acc) return NULL;
+                cons_list_init(f.acc);
+            } else {
+                /* Clone before chaining: values may share structure. */
+                Cons* v = cons_clone_shallow(reg, arena);
+                if (!v) return NULL;
+                cons_list_push_back(f.acc, v);
+            }
+
+            if (f.pending) {
+                Cons* next = f.pending;
+                f.pending = next->cdr;
+                if (frames_push(&stack, f, arena) != 0 ||
+                    frames_push(&stack, (Frame){ .kind = F_EVAL,
+                                .expr = next, .env = f.env,
+                                .act = f.act }, arena) != 0) {
+                    return NULL;
+                }
+                break;
+            }
+
+            /* acc is (op arg...): split off the argument list. */
+            Cons* op = f.acc->head;
+            ConsList* args = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+            if (!args) return NULL;
+            args->head = op->cdr;
+            args->tail = op->cdr ? f.acc->tail : NULL;
+            args->length = f.acc->length - 1;
+
+            /* The accumulator header is dead once split; the header
+             * allocated per call feeds the next call's allocation. */
+            arena_recycle(*arena, f.acc, sizeof(ConsList));
+
+            if (op->type == NODE_LAMBDA) {
+                const Lambda* lam = (const Lambda*)op->car;
+                Symtab* call_env = NULL;
+                ActRec* rec = lambda_bind(lam, args, &call_env, arena);
+                if (!rec) return NULL;
+                /* lambda_bind copied the values out; only the header
+                 * dies (the value cells may live on in slots). */
+                arena_recycle(*arena, args, sizeof(ConsList));
+                /* The body replaces the call frame entirely: a call in
+                 * tail position reuses the current stack depth. */
+                if (frames_push(&stack, (Frame){ .kind = F_SEQ,
+                                .pending = lam->body, .env = call_env,
+                                .act = rec }, arena) != 0) {
+                    return NULL;
+                }
+                break;
+            }
+
+            if (op->type == NODE_BUILTIN) {
+                /* Resolved at parse time: dispatch is one array index. */
+                BuiltinType bt = *(const BuiltinType*)op->car;
+                WISP_STAT_BUILTIN(bt);
+                reg = builtin_dispatch_table[bt](args, arena);
+                if (!reg) return NULL;
+                arena_recycle(*arena, args, sizeof(ConsList));
+                break;
+            }
+
+            if (op->type == NODE_ATOM_SYM) {
+                const SymRef* ref = (const SymRef*)op->car;
+                struct BuiltinName* b = find_builtin(ref->name, strlen(ref->name));
+                if (!b) {
+                    fprintf(stderr, "Eval Error: '%s' is not a procedure.\n", ref->name);
+                    return NULL;
+                }
+                WISP_STAT_BUILTIN(b->type);
+                reg = builtin_dispatch_table[b->type](args, arena);
+                if (!reg) return NULL;
+                arena_recycle(*arena, args, sizeof(ConsList));
+                break;
+            }
+
+            fprintf(stderr, "Eval Error: object is not callable.\n");
+            return NULL;
+        }
+
+        }
+    }
+
+    return reg ? reg : cell_nil();
+}
+
+Cons* eval_expr(Cons* expr, Symtab* env, Arena** arena) {
+    return eval_run(expr, env, NULL, arena);
+}
+
+Cons* eval_program(const ConsList* program, Symtab* globals, Arena** scratch) {
+    if (!program || !globals || !scratch || !*scratch) return NULL;
+    /* The intern pool must outlive scratch resets. */
+    if (intern_init(globals->arena) != 0) return NULL;
+
+    /* 'nil' reads as a plain symbol; bind it once as a constant. */
+    SymRef nil_ref;
+    if (intern_ref(&nil_ref, "nil", 3) != 0) return NULL;
+    if (!symtab_lookup_ref(globals, &nil_ref)) {
+        if (!symtab_define_ref(globals, &nil_ref, cell_nil(), true)) {
+            return NULL;
+        }
+    }
+
+    Symtab* prev_global = g_global_env;
+    g_global_env = globals;
+
+    /*
+     * Two-tier scheme: temporaries go to scratch and are bulk-reset
+     * after every top-level form (escaping values were promoted into
+     * the target scope's arena by then). When the caller passes the
+     * persistent arena for both roles, resets are skipped and behavior
+     * degrades to the old grow-only mode.
+     */
+    Arena* scratch_head = *scratch;
+    bool two_tier = (scratch != globals->arena);
+
+    Cons* result = NULL;
+    for (Cons* form = program->head; form; form = form->cdr) {
+        result = eval_expr(form, globals, scratch);
+        if (!result) {
+            g_global_env = prev_global;
+            return NULL;
+        }
+        if (two_tier) {
+            if (!form->cdr) {
+                /* The program's value must survive the final reset. */
+                result = promote_value(result, globals->arena);
+            }
+            *scratch = arena_reset_chain(scratch_head);
+            if (!result) {
+                g_global_env = prev_global;
+                return NULL;
+            }
+        }
+    }
+
+    g_global_env = prev_global;
+    return result ? result : cell_nil();
+}
+
+/* ------------------ Meta builtins ------------------ */
+
+/*
+ * apply and eval live here rather than in builtins.c because they need
+ * the evaluator itself (and the global scope of the running program).
+ */
+
+static Cons* apply_now(Cons* op, ConsList* args, Arena** arena) {
+    if (op->type == NODE_LAMBDA) {
+        const Lambda* lam = (const Lambda*)op->car;
+        Symtab* call_env = NULL;
+        ActRec* rec = lambda_bind(lam, args, &call_env, arena);
+        if (!rec) return NULL;
+
+        Cons* result = NULL;
+        for (Cons* form = lam->body; form; form = form->cdr) {
+            result = eval_run(form, call_env, rec, arena);
+            if (!result) return NULL;
+        }
+        return result;
+    }
+
+    if (op->type == NODE_BUILTIN) {
+        BuiltinType bt = *(const BuiltinType*)op->car;
+        WISP_STAT_BUILTIN(bt);
+        return builtin_dispatch_table[bt](args, arena);
+    }
+
+    if (op->type == NODE_ATOM_SYM) {
+        const SymRef* ref = (const SymRef*)op->car;
+        struct BuiltinName* b = find_builtin(ref->name, strlen(ref->name));
+        if (b) {
+            WISP_STAT_BUILTIN(b->type);
+            return builtin_dispatch_table[b->type](args, arena);
+        }
+    }
+
+    fprintf(stderr, "Eval Error: 'apply' on a non-procedure.\n");
+    return NULL;
+}
+
+/* ------------------ Bytecode VM entry points (@see vm.h) ------------- */
+
+Cons* eval_apply_value(Cons* op, ConsList* args, Arena** arena) {
+    return apply_now(op, args, arena);
+}
+
+Cons* eval_make_closure(ConsList* params, Cons* body, Symtab* env,
+                        Arena** arena) {
+    return make_lambda(params, body, env, NULL, NULL, 0, arena);
+}
+
+Symtab* eval_set_global_env(Symtab* env) {
+    Symtab* prev = g_global_env;
+    g_global_env = env;
+    return prev;
+}
+
+Cons* builtin_apply(ConsList* args, Arena** arena) {
+    if (!args || args->length != 2 || !is_sublist(args->head->cdr)) {
+        fprintf(stderr, "Eval Error: 'apply' expects a procedure and a list.\n");
+        return NULL;
+    }
+
+    ConsList* call_args = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!call_args) return NULL;
+    cons_list_init(call_args);
+
+    const Cons* listnode = args->head->cdr;
+    if (listnode->type == NODE_VECTOR_LIST) {
+        const VecList* vl = (const VecList*)listnode->car;
+        for (size_t i = 0; i < vl->count; i++) {
+            Cons* v = cons_clone_shallow(vl->items[i], arena);
+            if (!v) return NULL;
+            cons_list_push_back(call_args, v);
+        }
+    } else {
+        const ConsList* src = *(ConsList* const*)listnode->car;
+        for (const Cons* c = src ? src->head : NULL; c; c = c->cdr) {
+            Cons* v = cons_clone_shallow(c, arena);
+            if (!v) return NULL;
+            cons_list_push_back(call_args, v);
+        }
+    }
+
+    return apply_now(args->head, call_args, arena);
+}
+
+/*
+ * Quoted data reaches 'eval' in the contiguous layout, but the evaluator
+ * dispatches calls and special forms over cdr chains: rebuild NODE_LIST
+ * structure for the form (and any nested forms) before re-entering.
+ */
+static Cons* devectorize(Cons* expr, Arena** arena) {
+    if (expr->type != NODE_VECTOR_LIST) return expr;
+
+    const VecList* v = (const VecList*)expr->car;
+    ConsList* form = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!form) return NULL;
+    cons_list_init(form);
+
+    for (size_t i = 0; i < v->count; i++) {
+        Cons* child = devectorize(v->items[i], arena);
+        if (!child) return NULL;
+        Cons* cell = cons_clone_shallow(child, arena);
+        if (!cell) return NULL;
+        cons_list_push_back(form, cell);
+    }
+    return make_atom(&form, sizeof(ConsList*), NODE_LIST, arena);
+}
+
+Cons* builtin_eval(ConsList* args, Arena** arena) {
+    if (!args || args->length != 1) {
+        fprintf(stderr, "Eval Error: 'eval' expects one form.\n");
+        return NULL;
+    }
+    if (!g_global_env) {
+        fprintf(stderr, "Eval Error: 'eval' outside a running program.\n");
+        return NULL;
+    }
+    Cons* form = devectorize(args->head, arena);
+    if (!form) return NULL;
+    return eval_expr(form, g_global_env, arena);
+}
+
+/* ------------------ Parallel map ------------------ */
+
+/*
+ * (pmap f list) applies f to every element on a pool of worker threads,
+ * block-partitioned like the parallel lexer, each worker evaluating into
+ * its own arena chain. The shared state a worker touches is read-only
+ * for the duration of the map: the operator, its captured scope and the
+ * global table see no defines (defines inside the applied lambda land in
+ * per-call frame tables on the worker's arena), and the global inline
+ * cache stands down (@see sym_cache_lookup). Results are promoted into
+ * the caller's arena after the join, then the worker chains are freed.
+ * Element order is preserved; side effects in f (display and friends)
+ * interleave. Nested pmap and failed spawns fall back to the sequential
+ * path, which any proper list also takes when it is too short to be
+ * worth the thread startup.
+ */
+
+#define PMAP_MAX_THREADS 16
+#define PMAP_MIN_ITEMS 8
+#define PMAP_ARENA_SIZE (1u << 16)
+
+typedef struct PmapJob {
+    Cons* op;               ///< Shared operator (read-only)
+    Cons* const* items;     ///< Shared element array (read-only)
+    Cons** results;         ///< Shared result array (disjoint slices)
+    size_t start, end;      ///< This worker's half-open index range
+    Arena* arena;           ///< Thread-local arena chain head
+    bool ok;
+} PmapJob;
+
+/* Apply op to one element; the single-cell argument list is recycled by
+ * the caller's loop via the header trick the evaluator uses. */
+static Cons* pmap_apply_one(Cons* op, const Cons* item, Arena** arena) {
+    ConsList* one = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!one) return NULL;
+    cons_list_init(one);
+    Cons* v = cons_clone_shallow(item, arena);
+    if (!v) return NULL;
+    cons_list_push_back(one, v);
+    Cons* r = apply_now(op, one, arena);
+    arena_recycle(*arena, one, sizeof(ConsList));
+    return r;
+}
+
+static void* pmap_job_run(void* p) {
+    PmapJob* job = (PmapJob*)p;
+    Arena* cursor = job->arena;
+    for (size_t i = job->start; i < job->end; i++) {
+        job->results[i] = pmap_apply_one(job->op, job->items[i], &cursor);
+        if (!job->results[i]) return NULL;
+    }
+    job->ok = true;
+    return NULL;
+}
+
+static Cons* pmap_seq(Cons* op, Cons* const* items, Cons** results,
+                      size_t count, Arena** arena) {
+    for (size_t i = 0; i < count; i++) {
+        results[i] = pmap_apply_one(op, items[i], arena);
+        if (!results[i]) return NULL;
+    }
+    return make_vector_list(results, count, arena);
+}
+
+Cons* builtin_pmap(ConsList* args, Arena** arena) {
+    if (!args || args->length != 2 || !is_sublist(args->head->cdr)) {
+        fprintf(stderr, "Eval Error: 'pmap' expects a procedure and a list.\n");
+        return NULL;
+    }
+
+    Cons* op = args->head;
+    const Cons* listnode = args->head->cdr;
+
+    /* Flatten either list layout into an index-addressable array. */
+    size_t count;
+    Cons* const* items;
+    if (listnode->type == NODE_VECTOR_LIST) {
+        const VecList* vl = (const VecList*)listnode->car;
+        count = vl->count;
+        items = vl->items;
+    } else {
+        const ConsList* src = *(ConsList* const*)listnode->car;
+        count = src ? src->length : 0;
+        Cons** flat = NULL;
+        if (count) {
+            flat = (Cons**)arena_alloc(arena, count * sizeof(Cons*));
+            if (!flat) return NULL;
+            size_t i = 0;
+            for (Cons* c = src->head; c; c = c->cdr) flat[i++] = c;
+        }
+        items = flat;
+    }
+    if (!count) return make_vector_list(NULL, 0, arena);
+
+    Cons** results = (Cons**)arena_alloc(arena, count * sizeof(Cons*));
+    if (!results) return NULL;
+
+    long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t nthreads = ncpu > 0 ? (size_t)ncpu : 1;
+    if (nthreads > PMAP_MAX_THREADS) nthreads = PMAP_MAX_THREADS;
+    if (nthreads > count) nthreads = count;
+
+    if (nthreads < 2 || count < PMAP_MIN_ITEMS || g_eval_parallel) {
+        return pmap_seq(op, items, results, count, arena);
+    }
+
+    /* Lazily-built shared state must exist before threads race to it. */
+    cell_nil();
+    if (special_forms_init() != 0) return NULL;
+
+    PmapJob jobs[PMAP_MAX_THREADS] = { 0 };
+    pthread_t threads[PMAP_MAX_THREADS];
+    size_t spawned = 0;
+    size_t per = (count + nthreads - 1) / nthreads;
+
+    g_eval_parallel = true;
+    for (size_t i = 0; i < nthreads; i++) {
+        size_t start = i * per;
+        if (start >= count) break;
+        size_t end = start + per < count ? start + per : count;
+
+        jobs[i] = (PmapJob){ .op = op, .items = items, .results = results,
+                             .start = start, .end = end,
+                             .arena = arena_create(PMAP_ARENA_SIZE) };
+        if (!jobs[i].arena) goto fail;
+        if (pthread_create(&threads[spawned], NULL, pmap_job_run,
+                           &jobs[i]) != 0) {
+            arena_free(jobs[i].arena);
+            jobs[i].arena = NULL;
+            goto fail;
+        }
+        spawned++;
+    }
+
+    for (size_t i = 0; i < spawned; i++) pthread_join(threads[i], NULL);
+    g_eval_parallel = false;
+
+    bool all_ok = true;
+    for (size_t i = 0; i < spawned; i++) all_ok &= jobs[i].ok;
+
+    if (all_ok) {
+        /* Copy results out before their arenas go away. */
+        for (size_t i = 0; i < count && all_ok; i++) {
+            results[i] = promote_value(results[i], arena);
+            all_ok = results[i] != NULL;
+        }
+    }
+    for (size_t i = 0; i < spawned; i++) arena_free(jobs[i].arena);
+    if (!all_ok) return NULL;   /* a worker already reported its error */
+
+    return make_vector_list(results, count, arena);
+
+fail:
+    /* Could not field a full pool: join what started, drop its work and
+     * run the whole map sequentially (same shape as the lexer fallback). */
+    for (size_t i = 0; i < spawned; i++) pthread_join(threads[i], NULL);
+    for (size_t i = 0; i < nthreads; i++) {
+        if (jobs[i].arena) arena_free(jobs[i].arena);
+    }
+    g_eval_parallel = false;
+    return pmap_seq(op, items, results, count, arena);
+}
@@ -5,12 +5,13 @@
 #define EVAL_H
 
 
-#include "builtins.h"
 #include "parser.h"
 #include "arena.h"
 
 #include <stdint.h>
 
+struct Symtab;
+
 typedef enum BuiltinType : uint8_t {
     BUILTIN_ADD,
     BUILTIN_SUB,
@@ -40,9 +41,113 @@ typedef enum BuiltinType : uint8_t {
     BUILTIN_NEWLINE,
     BUILTIN_APPLY,
     BUILTIN_EVAL,
-    BUILTIN_EXIT
+    BUILTIN_EXIT,
+    BUILTIN_PMAP,
+
+    BUILTIN_COUNT               ///< Number of builtins (dispatch table size)
 } BuiltinType;
 
 typedef Cons* (*builtin_fn)(ConsList* args, Arena** arena);
 
+/* ---------------- Closures ---------------- */
+
+/**
+ * @brief Flat activation record: one call's parameters, indexed by slot.
+ *
+ * Pushed for every lambda invocation as a bump allocation (no hashing,
+ * no memset of table slots). NODE_LOCAL_REF reads resolved by the
+ * locals pass (@see passes.h) walk `up` depth times and index `slots`
+ * directly; the Symtab chain remains only for globals, free variables
+ * and bodies with internal defines.
+ */
+typedef struct ActRec {
+    struct ActRec* up;      ///< Enclosing lambda's record (lexical, not dynamic)
+    Cons** slots;           ///< One evaluated argument per parameter
+    size_t count;
+    Arena** arena;          ///< Owning arena (set! promotion, @see eval.c)
+} ActRec;
+
+/**
+ * @brief Payload of a NODE_LAMBDA cons: code plus captured environment.
+ *
+ * The parameter list and body are shared with the AST (no copy); the
+ * environment pointer captures the defining scope, so inner lambdas see
+ * outer bindings lexically. `act` captures the activation-record chain
+ * the closure was created under, for slot-resolved references to outer
+ * parameters. `caps` holds the values the locals pass flattened out of
+ * that chain (@see LambdaSig): lambda_bind appends them after the
+ * parameters, so the planned depth-0 slot reads find them. `has_defines`
+ * marks bodies containing internal defines: those calls fall back to a
+ * full child Symtab so runtime bindings keep working.
+ */
+typedef struct Lambda {
+    ConsList* params;       ///< List of NODE_ATOM_SYM parameter names
+    Cons* body;             ///< First body form (cdr-chained sequence)
+    struct Symtab* env;     ///< Defining scope
+    ActRec* act;            ///< Captured activation-record chain (may be NULL)
+    Cons** caps;            ///< Captured values, bound after the parameters
+    uint32_t cap_count;
+    bool has_defines;       ///< Body defines locals: calls need a Symtab
+} Lambda;
+
+/* ---------------- Evaluator ---------------- */
+
+/**
+ * @brief Evaluate a single expression.
+ *
+ * The driver is a loop over an explicit arena-backed frame stack rather
+ * than C recursion: tail positions (an if branch, the last form of a
+ * body) push no extra frames, so tail-recursive loops run in constant
+ * stack space, and deep non-tail recursion grows the heap stack instead
+ * of overflowing the C stack.
+ *
+ * @return The result value, or NULL on error (reported on stderr).
+ */
+Cons* eval_expr(Cons* expr, struct Symtab* env, Arena** arena);
+
+/**
+ * @brief Evaluate every top-level form of a program in order.
+ *
+ * Temporaries are allocated from @p scratch, which is bulk-reset after
+ * each top-level form; values that escape into a persistent scope (the
+ * globals' arena) are deep-copied out first. Passing the persistent
+ * arena as @p scratch disables the resets.
+ *
+ * @return The value of the last form (nil for an empty program), or
+ *         NULL if any form fails.
+ */
+Cons* eval_program(const ConsList* program, struct Symtab* globals, Arena** scratch);
+
+/* ---------------- Bytecode VM entry points (@see vm.h) ---------------- */
+
+/**
+ * @brief Apply an already-evaluated procedure value to evaluated args.
+ *
+ * The single procedure dispatch shared by 'apply', pmap and the VM's
+ * OP_CALL_VALUE: closures run their bodies through the evaluator
+ * (binding, tail calls and captures included), builtins go straight to
+ * the dispatch table.
+ *
+ * @return The result value, or NULL on error (reported on stderr).
+ */
+Cons* eval_apply_value(Cons* op, ConsList* args, Arena** arena);
+
+/**
+ * @brief Build a closure over @p env with no activation-record chain.
+ *
+ * For closures created outside any lambda frame (the VM's OP_CLOSURE
+ * runs top-level code only): captures are empty and free variables
+ * resolve through @p env.
+ */
+Cons* eval_make_closure(ConsList* params, Cons* body, struct Symtab* env,
+                        Arena** arena);
+
+/**
+ * @brief Swap the global scope 'eval' and 'apply' resolve through.
+ *
+ * eval_program sets it for the program it runs; the VM must do the same
+ * around a chunk. @return The previous scope, to restore afterwards.
+ */
+struct Symtab* eval_set_global_env(struct Symtab* env);
+
 #endif
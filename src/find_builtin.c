@@ -36,9 +36,8 @@
 
 #line 1 "builtins.gperf"
 
-#include "eval.h"
 #line 4 "builtins.gperf"
-struct BuiltinName { const char* name; BuiltinType type; };
+struct BuiltinName;
 
 #define TOTAL_KEYWORDS 29
 #define MIN_WORD_LENGTH 1
@@ -101,7 +100,7 @@ hash (register const char *str, register size_t len)
 }
 
 struct BuiltinName *
-find_builtin (register const char *str, register size_t len)
+find_builtin_perfect (register const char *str, register size_t len)
 {
   static struct BuiltinName wordlist[] =
     {
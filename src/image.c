@@ -0,0 +1,375 @@
+/*
+ * @file image.c
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "image.h"
+#include "intern.h"
+
+#define IMAGE_MAGIC 0x50534957u     /* "WISP" little-endian */
+#define IMAGE_VERSION 8u    /* v8: lambda signatures with capture plans */
+#define IMAGE_SUFFIX ".wispc"
+#define IMAGE_NULL UINT64_MAX       /* serialized NULL pointer */
+
+static_assert(sizeof(void*) == sizeof(uint64_t),
+              "AST images store offsets in pointer-sized fields");
+
+typedef struct ImageHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t source_size;       ///< st_size of the source when saved
+    uint64_t source_mtime;      ///< st_mtime of the source when saved
+    uint64_t root_offset;       ///< Offset of the program ConsList
+    uint64_t ptr_reloc_offset;  ///< Offset of the pointer relocation table
+    uint64_t ptr_reloc_count;
+    uint64_t sym_reloc_offset;  ///< Offset of the SymRef re-intern table
+    uint64_t sym_reloc_count;
+    uint64_t total_size;
+} ImageHeader;
+
+/* ------------------ Writer ------------------ */
+
+/*
+ * Cold-path growable byte buffer (plain malloc: image writing happens
+ * once per changed source, outside the arena lifecycle). Relocation
+ * entries are file offsets of pointer-sized fields whose stored value is
+ * itself an offset (or IMAGE_NULL).
+ */
+typedef struct Out {
+    uint8_t* buf;
+    size_t len;
+    size_t cap;
+    uint64_t* ptr_relocs;
+    size_t ptr_reloc_len, ptr_reloc_cap;
+    uint64_t* sym_relocs;
+    size_t sym_reloc_len, sym_reloc_cap;
+    bool oom;
+} Out;
+
+static uint64_t out_reserve(Out* o, size_t n) {
+    size_t aligned = (o->len + 7u) & ~(size_t)7u;
+    if (aligned + n > o->cap) {
+        size_t new_cap = o->cap ? o->cap * 2 : 4096;
+        while (new_cap < aligned + n) new_cap *= 2;
+        uint8_t* nb = realloc(o->buf, new_cap);
+        if (!nb) { o->oom = true; return 0; }
+        o->buf = nb;
+        o->cap = new_cap;
+    }
+    memset(o->buf + o->len, 0, aligned + n - o->len);
+    o->len = aligned + n;
+    return (uint64_t)aligned;
+}
+
+static void add_reloc(uint64_t** table, size_t* len, size_t* cap, uint64_t where, bool* oom) {
+    if (*len >= *cap) {
+        size_t new_cap = *cap ? *cap * 2 : 256;
+        uint64_t* nt = realloc(*table, new_cap * sizeof(uint64_t));
+        if (!nt) { *oom = true; return; }
+        *table = nt;
+        *cap = new_cap;
+    }
+    (*table)[(*len)++] = where;
+}
+
+static void note_ptr(Out* o, uint64_t field_offset, uint64_t target_offset) {
+    *(uint64_t*)(o->buf + field_offset) = target_offset;
+    add_reloc(&o->ptr_relocs, &o->ptr_reloc_len, &o->ptr_reloc_cap, field_offset, &o->oom);
+}
+
+static uint64_t write_string(Out* o, const char* s) {
+    size_t n = strlen(s) + 1;
+    uint64_t off = out_reserve(o, n);
+    if (o->oom) return 0;
+    memcpy(o->buf + off, s, n);
+    return off;
+}
+
+static uint64_t write_conslist(Out* o, const ConsList* list);
+
+/* Serialize one cons cell (without following cdr). */
+static uint64_t write_cons(Out* o, const Cons* c) {
+    size_t total = sizeof(Cons) + c->size;
+    uint64_t off = out_reserve(o, total);
+    if (o->oom) return 0;
+    memcpy(o->buf + off, c, total);
+
+    Cons* rec = (Cons*)(o->buf + off);
+    rec->cdr = NULL;    /* relinked by the caller when part of a chain */
+
+    uint64_t car_off = off + (uint64_t)offsetof(Cons, car);
+
+    switch (c->type) {
+        case NODE_LIST: {
+            const ConsList* sub = *(ConsList* const*)c->car;
+            uint64_t sub_off = sub ? write_conslist(o, sub) : IMAGE_NULL;
+            if (o->oom) return 0;
+            note_ptr(o, car_off, sub_off);
+            break;
+        }
+
+        case NODE_QUOTE:
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE: {
+            const Cons* inner = *(Cons* const*)c->car;
+            uint64_t inner_off = inner ? write_cons(o, inner) : IMAGE_NULL;
+            if (o->oom) return 0;
+            note_ptr(o, car_off, inner_off);
+            break;
+        }
+
+        case NODE_ATOM_SYM: {
+            const SymRef* ref = (const SymRef*)c->car;
+            uint64_t name_off = write_string(o, ref->name);
+            if (o->oom) return 0;
+            uint64_t name_field = car_off + (uint64_t)offsetof(SymRef, name);
+            note_ptr(o, name_field, name_off);
+            /* IDs are pool-local: re-intern on load. */
+            add_reloc(&o->sym_relocs, &o->sym_reloc_len, &o->sym_reloc_cap,
+                      car_off, &o->oom);
+            break;
+        }
+
+        case NODE_ATOM_STR: {
+            /* The whole block (header + bytes) round-trips verbatim;
+             * relocation just re-aims the car slot at it. */
+            const WispStr* s = *(WispStr* const*)c->car;
+            size_t s_total = sizeof(WispStr) + s->len + 1;
+            uint64_t s_off = out_reserve(o, s_total);
+            if (o->oom) return 0;
+            memcpy(o->buf + s_off, s, s_total);
+            note_ptr(o, car_off, s_off);
+            break;
+        }
+
+        case NODE_ATOM_UNINTERNED: {
+            uint64_t s_off = write_string(o, *(char* const*)c->car);
+            if (o->oom) return 0;
+            note_ptr(o, car_off, s_off);
+            break;
+        }
+
+        case NODE_LOCAL_REF: {
+            /* depth/slot are plain data; only the diagnostic name needs
+             * relocating. */
+            const LocalRef* lr = (const LocalRef*)c->car;
+            uint64_t name_off = write_string(o, lr->name);
+            if (o->oom) return 0;
+            note_ptr(o, car_off + (uint64_t)offsetof(LocalRef, name), name_off);
+            break;
+        }
+
+        case NODE_LAMBDA_SIG: {
+            /* Capture entries are plain data; the block needs its own
+             * relocation plus one for the embedded params pointer. */
+            const LambdaSig* sig = *(LambdaSig* const*)c->car;
+            size_t sig_total = sizeof(LambdaSig) +
+                               sig->cap_count * sizeof(CaptureRef);
+            uint64_t sig_off = out_reserve(o, sig_total);
+            if (o->oom) return 0;
+            memcpy(o->buf + sig_off, sig, sig_total);
+
+            uint64_t params_off = sig->params
+                ? write_conslist(o, sig->params) : IMAGE_NULL;
+            if (o->oom) return 0;
+            note_ptr(o, sig_off + (uint64_t)offsetof(LambdaSig, params),
+                     params_off);
+            note_ptr(o, car_off, sig_off);
+            break;
+        }
+
+        case NODE_VECTOR_LIST: {
+            const VecList* v = (const VecList*)c->car;
+            uint64_t items_field = car_off + (uint64_t)offsetof(VecList, items);
+
+            if (!v->count) {
+                note_ptr(o, items_field, IMAGE_NULL);
+                break;
+            }
+
+            /* Children first, then the pointer array: each slot and the
+             * items field itself are ordinary pointer relocations. */
+            uint64_t* offs = malloc(v->count * sizeof(uint64_t));
+            if (!offs) { o->oom = true; return 0; }
+            for (size_t i = 0; i < v->count; i++) {
+                offs[i] = write_cons(o, v->items[i]);
+                if (o->oom) { free(offs); return 0; }
+            }
+
+            uint64_t arr_off = out_reserve(o, v->count * sizeof(Cons*));
+            if (o->oom) { free(offs); return 0; }
+            for (size_t i = 0; i < v->count; i++) {
+                note_ptr(o, arr_off + i * sizeof(Cons*), offs[i]);
+            }
+            free(offs);
+
+            note_ptr(o, items_field, arr_off);
+            break;
+        }
+
+        default:
+            /* Ints, floats, nil: payload is self-contained. */
+            break;
+    }
+
+    return off;
+}
+
+static uint64_t write_conslist(Out* o, const ConsList* list) {
+    uint64_t off = out_reserve(o, sizeof(ConsList));
+    if (o->oom) return 0;
+
+    ConsList* rec = (ConsList*)(o->buf + off);
+    rec->length = list->length;
+
+    uint64_t head_off = IMAGE_NULL;
+    uint64_t prev_off = IMAGE_NULL;
+    uint64_t last_off = IMAGE_NULL;
+
+    for (const Cons* c = list->head; c; c = c->cdr) {
+        uint64_t c_off = write_cons(o, c);
+        if (o->oom) return 0;
+
+        if (head_off == IMAGE_NULL) {
+            head_off = c_off;
+        } else {
+            note_ptr(o, prev_off + (uint64_t)offsetof(Cons, cdr), c_off);
+        }
+        prev_off = c_off;
+        last_off = c_off;
+    }
+
+    note_ptr(o, off + (uint64_t)offsetof(ConsList, head), head_off);
+    note_ptr(o, off + (uint64_t)offsetof(ConsList, tail), last_off);
+    return off;
+}
+
+static uint64_t write_table(Out* o, const uint64_t* table, size_t count) {
+    uint64_t off = out_reserve(o, count * sizeof(uint64_t));
+    if (o->oom) return 0;
+    memcpy(o->buf + off, table, count * sizeof(uint64_t));
+    return off;
+}
+
+static void image_path_for(char* dst, size_t dst_len, const char* source_path) {
+    snprintf(dst, dst_len, "%s%s", source_path, IMAGE_SUFFIX);
+}
+
+int image_save(const char* source_path, const ConsList* program) {
+    if (!source_path || !program) return -1;
+
+    struct stat st;
+    if (stat(source_path, &st) != 0) return -1;
+
+    Out o = { 0 };
+    uint64_t hdr_off = out_reserve(&o, sizeof(ImageHeader));
+    (void)hdr_off;
+
+    uint64_t root = write_conslist(&o, program);
+    uint64_t ptr_table = write_table(&o, o.ptr_relocs, o.ptr_reloc_len);
+    uint64_t sym_table = write_table(&o, o.sym_relocs, o.sym_reloc_len);
+
+    int rc = -1;
+    if (!o.oom) {
+        ImageHeader* hdr = (ImageHeader*)o.buf;
+        hdr->magic = IMAGE_MAGIC;
+        hdr->version = IMAGE_VERSION;
+        hdr->source_size = (uint64_t)st.st_size;
+        hdr->source_mtime = (uint64_t)st.st_mtime;
+        hdr->root_offset = root;
+        hdr->ptr_reloc_offset = ptr_table;
+        hdr->ptr_reloc_count = o.ptr_reloc_len;
+        hdr->sym_reloc_offset = sym_table;
+        hdr->sym_reloc_count = o.sym_reloc_len;
+        hdr->total_size = o.len;
+
+        char path[4096];
+        image_path_for(path, sizeof(path), source_path);
+
+        int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd != -1) {
+            ssize_t written = write(fd, o.buf, o.len);
+            close(fd);
+            if (written == (ssize_t)o.len) rc = 0;
+            else unlink(path);
+        }
+    }
+
+    free(o.buf);
+    free(o.ptr_relocs);
+    free(o.sym_relocs);
+    return rc;
+}
+
+/* ------------------ Loader ------------------ */
+
+ConsList* image_load(const char* source_path, Arena** arena) {
+    if (!source_path || !arena || !*arena) return NULL;
+
+    struct stat src_st;
+    if (stat(source_path, &src_st) != 0) return NULL;
+
+    char path[4096];
+    image_path_for(path, sizeof(path), source_path);
+
+    int fd = open(path, O_RDONLY);
+    if (fd == -1) return NULL;
+
+    struct stat img_st;
+    if (fstat(fd, &img_st) != 0 || (size_t)img_st.st_size < sizeof(ImageHeader)) {
+        close(fd);
+        return NULL;
+    }
+
+    /* Private mapping: relocation fixups stay in our address space. */
+    uint8_t* base = mmap(NULL, (size_t)img_st.st_size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return NULL;
+
+    const ImageHeader* hdr = (const ImageHeader*)base;
+    if (hdr->magic != IMAGE_MAGIC ||
+        hdr->version != IMAGE_VERSION ||
+        hdr->source_size != (uint64_t)src_st.st_size ||
+        hdr->source_mtime != (uint64_t)src_st.st_mtime ||
+        hdr->total_size != (uint64_t)img_st.st_size) {
+        munmap(base, (size_t)img_st.st_size);
+        return NULL;
+    }
+
+    if (intern_init(arena) != 0) {
+        munmap(base, (size_t)img_st.st_size);
+        return NULL;
+    }
+
+    /* One pass: offsets become pointers. */
+    const uint64_t* ptr_relocs = (const uint64_t*)(base + hdr->ptr_reloc_offset);
+    for (uint64_t i = 0; i < hdr->ptr_reloc_count; i++) {
+        uint64_t* field = (uint64_t*)(base + ptr_relocs[i]);
+        *field = (*field == IMAGE_NULL) ? 0 : (uint64_t)(uintptr_t)(base + *field);
+    }
+
+    /* Re-intern symbols so IDs are dense in the live pool. */
+    const uint64_t* sym_relocs = (const uint64_t*)(base + hdr->sym_reloc_offset);
+    for (uint64_t i = 0; i < hdr->sym_reloc_count; i++) {
+        SymRef* ref = (SymRef*)(base + sym_relocs[i]);
+        SymRef fresh;
+        if (intern_ref(&fresh, ref->name, strlen(ref->name)) != 0) {
+            munmap(base, (size_t)img_st.st_size);
+            return NULL;
+        }
+        *ref = fresh;
+    }
+
+    return (ConsList*)(base + hdr->root_offset);
+}
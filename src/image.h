@@ -0,0 +1,50 @@
+/**
+ * @file image.h
+ * @brief Precompiled AST image cache (serialize parse output, mmap it back).
+ *
+ * After a successful parse the arena-resident Cons/ConsList graph can be
+ * flattened into a sidecar file next to the source (<source>.wispc): all
+ * pointer fields are stored as file offsets and listed in a relocation
+ * table. On the next startup the image is mmap'd and fixed up in a single
+ * linear pass over the relocations, skipping lex_tokens/parse_stream
+ * entirely. Interned symbols are re-interned against the live pool during
+ * fixup so SymRef IDs stay dense and canonical.
+ *
+ * The image encodes the in-memory layout of the running build; it is a
+ * local cache, not an interchange format. A stale or foreign image is
+ * detected via the header (magic, layout version, source size + mtime)
+ * and simply ignored.
+ */
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include "arena.h"
+#include "parser.h"
+
+/**
+ * @brief Serialize a parsed program to <source_path>.wispc.
+ *
+ * @param source_path Path of the .wisp source the program came from
+ *                    (used to derive the image path and record staleness
+ *                    metadata).
+ * @param program Parse output to serialize.
+ * @return 0 on success, -1 on error (the cache is best-effort; callers
+ *         may ignore failures).
+ */
+int image_save(const char* source_path, const ConsList* program);
+
+/**
+ * @brief Load a previously saved image for a source file.
+ *
+ * Checks the header against the current source file and layout version;
+ * on any mismatch returns NULL so the caller falls back to parsing. The
+ * returned AST lives in the image mapping, which stays mapped for the
+ * lifetime of the process.
+ *
+ * @param source_path Path of the .wisp source.
+ * @param arena Arena used for re-interning symbol names.
+ * @return The program's ConsList, or NULL if no usable image exists.
+ */
+ConsList* image_load(const char* source_path, Arena** arena);
+
+#endif
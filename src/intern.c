@@ -0,0 +1,146 @@
+/*
+ * @file intern.c
+ */
+#include "intern.h"
+
+#include <string.h>
+
+#define INTERN_INITIAL_SIZE 256     ///< Slots in the probe table (power of two)
+#define INTERN_NAMES_INITIAL 128    ///< Initial id -> name array capacity
+#define INTERN_EMPTY UINT32_MAX     ///< Sentinel for an unused probe slot
+
+/*
+ * Open-addressing table (linear probing, power-of-two sized) mapping
+ * name -> id, plus a dense id -> name array. Everything lives in the
+ * arena handed to intern_init; nothing is ever freed individually.
+ */
+typedef struct InternPool {
+    uint32_t* hashes;           ///< Cached hash per slot
+    uint32_t* ids;              ///< Symbol ID per slot, INTERN_EMPTY if unused
+    size_t size;                ///< Number of slots
+    size_t count;               ///< Number of interned symbols
+    const char** names;         ///< Dense id -> canonical name
+    size_t names_cap;           ///< Capacity of names
+    Arena** arena;              ///< Arena for slots, names and string copies
+} InternPool;
+
+static InternPool g_pool;
+static bool g_pool_ready = false;
+
+uint32_t intern_hash(const char* str, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static int pool_alloc_slots(InternPool* p, size_t size) {
+    p->hashes = (uint32_t*)arena_alloc(p->arena, sizeof(uint32_t) * size);
+    p->ids    = (uint32_t*)arena_alloc(p->arena, sizeof(uint32_t) * size);
+    if (!p->hashes || !p->ids) return -1;
+
+    memset(p->hashes, 0, sizeof(uint32_t) * size);
+    memset(p->ids, 0xFF, sizeof(uint32_t) * size);
+    p->size = size;
+    return 0;
+}
+
+int intern_init(Arena** arena) {
+    if (g_pool_ready) return 0;
+    if (!arena || !*arena) return -1;
+
+    g_pool.arena = arena;
+    g_pool.count = 0;
+
+    if (pool_alloc_slots(&g_pool, INTERN_INITIAL_SIZE) != 0) return -1;
+
+    g_pool.names = (const char**)arena_alloc(arena, sizeof(char*) * INTERN_NAMES_INITIAL);
+    if (!g_pool.names) return -1;
+    g_pool.names_cap = INTERN_NAMES_INITIAL;
+
+    g_pool_ready = true;
+    return 0;
+}
+
+static int pool_grow(InternPool* p) {
+    uint32_t* old_hashes = p->hashes;
+    uint32_t* old_ids = p->ids;
+    size_t old_size = p->size;
+
+    if (pool_alloc_slots(p, old_size * 2) != 0) return -1;
+
+    for (size_t i = 0; i < old_size; i++) {
+        if (old_ids[i] == INTERN_EMPTY) continue;
+
+        size_t idx = old_hashes[i] & (p->size - 1);
+        while (p->ids[idx] != INTERN_EMPTY)
+            idx = (idx + 1) & (p->size - 1);
+
+        p->hashes[idx] = old_hashes[i];
+        p->ids[idx] = old_ids[i];
+    }
+    return 0;
+}
+
+int intern_ref(SymRef* out, const char* str, size_t len) {
+    if (!g_pool_ready || !out || !str) return -1;
+
+    InternPool* p = &g_pool;
+    uint32_t hash = intern_hash(str, len);
+
+    size_t idx = hash & (p->size - 1);
+    while (p->ids[idx] != INTERN_EMPTY) {
+        if (p->hashes[idx] == hash) {
+            const char* name = p->names[p->ids[idx]];
+            if (strncmp(name, str, len) == 0 && name[len] == '\0') {
+                out->id = p->ids[idx];
+                out->hash = hash;
+                out->name = name;
+                return 0;
+            }
+        }
+        idx = (idx + 1) & (p->size - 1);
+    }
+
+    /* New symbol: copy the name once, then claim the slot. */
+    char* copy = (char*)arena_alloc(p->arena, len + 1);
+    if (!copy) return -1;
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    if (p->count >= p->names_cap) {
+        size_t new_cap = p->names_cap * 2;
+        const char** new_names =
+            (const char**)arena_alloc(p->arena, sizeof(char*) * new_cap);
+        if (!new_names) return -1;
+        memcpy(new_names, p->names, sizeof(char*) * p->count);
+        p->names = new_names;
+        p->names_cap = new_cap;
+    }
+
+    uint32_t id = (uint32_t)p->count;
+    p->names[id] = copy;
+    p->hashes[idx] = hash;
+    p->ids[idx] = id;
+    p->count++;
+
+    if (p->count * 4 >= p->size * 3) {
+        if (pool_grow(p) != 0) return -1;
+    }
+
+    out->id = id;
+    out->hash = hash;
+    out->name = copy;
+    return 0;
+}
+
+const char* intern_name(uint32_t id) {
+    if (!g_pool_ready || id >= g_pool.count) return NULL;
+    return g_pool.names[id];
+}
+
+uint32_t intern_count(void) {
+    return g_pool_ready ? (uint32_t)g_pool.count : 0;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file intern.h
+ * @brief Global symbol interning pool with dense integer symbol IDs.
+ *
+ * Every identifier the parser sees is interned exactly once; a symbol is
+ * then represented everywhere by a SymRef carrying its dense uint32_t ID,
+ * its cached FNV-1a hash, and the canonical NUL-terminated name in the
+ * pool's arena. Symbol equality becomes an integer compare and the symtab
+ * hot path skips both symtab_hash and strcmp.
+ */
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "arena.h"
+
+/**
+ * @struct SymRef
+ * @brief Resolved reference to an interned symbol.
+ *
+ * This is the payload of a NODE_ATOM_SYM cons cell. `name` points at the
+ * single canonical copy inside the intern pool and is stable for the
+ * lifetime of the pool, so it may be compared by pointer.
+ */
+typedef struct SymRef {
+    uint32_t id;                ///< Dense symbol ID (0-based, allocation order)
+    uint32_t hash;              ///< Cached FNV-1a hash of the name
+    const char* name;           ///< Canonical NUL-terminated name in the pool
+} SymRef;
+
+/* --------------- Core API ------------ */
+
+/**
+ * @brief Initialize the global intern pool (idempotent).
+ * @param arena Arena allocator backing the pool and its strings.
+ * @return 0 on success, -1 on error.
+ */
+int intern_init(Arena** arena);
+
+/**
+ * @brief Intern a (possibly non-NUL-terminated) name and fill a SymRef.
+ *
+ * Re-interning an existing name is a hash probe plus one memcmp and
+ * returns the same ID; new names are copied once into the pool's arena.
+ *
+ * @param out Receives the ID, cached hash and canonical name pointer.
+ * @param str Symbol name bytes.
+ * @param len Number of bytes in the name.
+ * @return 0 on success, -1 on error (pool not initialized or OOM).
+ */
+int intern_ref(SymRef* out, const char* str, size_t len);
+
+/**
+ * @brief Canonical name of an interned symbol.
+ * @return The name, or NULL if the ID has not been allocated.
+ */
+const char* intern_name(uint32_t id);
+
+/**
+ * @brief Number of distinct symbols interned so far.
+ */
+uint32_t intern_count(void);
+
+/**
+ * @brief FNV-1a hash over an explicit byte range.
+ *
+ * Matches symtab_hash on the same bytes so interned hashes are usable
+ * directly as Symtab probe hashes.
+ */
+uint32_t intern_hash(const char* str, size_t len);
+
+/* --------------- Inline Utilities ------------ */
+
+/**
+ * @brief Symbol equality: a single integer compare.
+ */
+static inline bool sym_ref_eq(const SymRef* a, const SymRef* b) {
+    return a->id == b->id;
+}
+
+#endif
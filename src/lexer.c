@@ -6,9 +6,21 @@
 #include "arena.h"
 
 #include <ctype.h>
+#include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/* Monomorphic token-vector accessors (@see VEC_DEFINE). */
+VEC_DEFINE(PackedToken)
+
 static const bool IDENTIFIER_CHAR_TABLE[256] = {
     ['!'] = true, ['@'] = true, ['#'] = true, ['$'] = true,
     ['%'] = true, ['^'] = true, ['&'] = true, ['*'] = true,
@@ -17,89 +29,199 @@ static const bool IDENTIFIER_CHAR_TABLE[256] = {
     ['.'] = true, ['_'] = true, ['\\'] = true, ['~'] = true,
 };
 
-Vec *lex_tokens(const char *source, size_t source_len, Arena** arena)
+/* ----------------- Wide scanning kernels ----------------- */
+
+/*
+ * Identifier-continue set (alnum + IDENTIFIER_CHAR_TABLE) folded into two
+ * derived tables, built once on the first lex_tokens call:
+ *   - IDENT_CONT_TABLE: plain 256-entry bool table for the scalar paths.
+ *   - ident_nibble_bitmap: the same set as a 16-byte nibble bitmap so a
+ *     single pshufb pair classifies 32 bytes at a time. Row = low nibble,
+ *     bit = high nibble; bytes >= 0x80 fall outside the bitmap and are
+ *     rejected (identifiers are ASCII).
+ */
+static bool IDENT_CONT_TABLE[256];
+static unsigned char ident_nibble_bitmap[16];
+static bool scan_tables_ready = false;
+
+/*
+ * First-character dispatch: one table load classifies the byte and the
+ * switch in lex_next compiles to a jump table, replacing the old
+ * if-else chain that re-tested c against every token kind (and fed the
+ * branch predictor a different pattern per source). Derived from
+ * IDENTIFIER_CHAR_TABLE alongside the other scan tables so the
+ * character sets stay defined in exactly one place.
+ */
+typedef enum CharKind : uint8_t {
+    CK_ERROR = 0,       ///< Not a token start
+    CK_SPACE,           ///< Whitespace (normally consumed by the wide skip)
+    CK_PUNCT,           ///< Single-char token; type in PUNCT_TOKEN
+    CK_COMMENT,         ///< ';'
+    CK_STRING,          ///< '"'
+    CK_DIGIT,           ///< '0'..'9'
+    CK_SIGN,            ///< '-' / '+': number when a digit or '.' follows
+    CK_HASH,            ///< '#': uninterned symbol when ':' follows
+    CK_IDENT            ///< Identifier start
+} CharKind;
+
+static uint8_t CHAR_KIND[256];
+static TokenType PUNCT_TOKEN[256];
+static bool IDENT_START_TABLE[256];
+
+static void build_scan_tables(void)
 {
-    Vec *tokens = arena_vec_new(arena, sizeof(Token), 64);
-    if (!tokens) return NULL;
+    for (int c = 0; c < 128; c++) {
+        if (isalnum(c) || IDENTIFIER_CHAR_TABLE[c]) {
+            IDENT_CONT_TABLE[c] = true;
+            ident_nibble_bitmap[c & 0x0F] |= (unsigned char) (1u << (c >> 4));
+        }
+        if (isalpha(c) || IDENTIFIER_CHAR_TABLE[c])
+            IDENT_START_TABLE[c] = true;
 
+        if (isspace(c))      CHAR_KIND[c] = CK_SPACE;
+        else if (isdigit(c)) CHAR_KIND[c] = CK_DIGIT;
+        else if (isalpha(c) || IDENTIFIER_CHAR_TABLE[c])
+            CHAR_KIND[c] = CK_IDENT;
+    }
 
-    const char *ptr = source;
-    const char *end = source + source_len;
+    /* Overrides for characters with their own handlers. */
+    CHAR_KIND['-'] = CK_SIGN;
+    CHAR_KIND['+'] = CK_SIGN;
+    CHAR_KIND['#'] = CK_HASH;
+    CHAR_KIND[';'] = CK_COMMENT;
+    CHAR_KIND['"'] = CK_STRING;
+    CHAR_KIND['('] = CK_PUNCT;  PUNCT_TOKEN['('] = TOKEN_LPAREN;
+    CHAR_KIND[')'] = CK_PUNCT;  PUNCT_TOKEN[')'] = TOKEN_RPAREN;
+    CHAR_KIND['\''] = CK_PUNCT; PUNCT_TOKEN['\''] = TOKEN_QUOTE;
+    CHAR_KIND[','] = CK_PUNCT;  PUNCT_TOKEN[','] = TOKEN_COMMA;
+    CHAR_KIND['`'] = CK_PUNCT;  PUNCT_TOKEN['`'] = TOKEN_BACKQUOTE;
+
+    scan_tables_ready = true;
+}
 
-    while (ptr < end) {
-        char c = *ptr;
+/*
+ * Skip a run of whitespace starting at ptr. The vector paths test
+ * c == ' ' plus the control range '\t'..'\r' (exactly the isspace set
+ * in the "C" locale) 32/16 bytes per iteration; the scalar tail
+ * handles the remainder and non-SIMD builds.
+ */
+static const char *skip_whitespace_wide(const char *ptr, const char *end)
+{
+#if defined(__AVX2__)
+    const __m256i v_space = _mm256_set1_epi8(' ');
+    const __m256i v_tab   = _mm256_set1_epi8('\t');
+    const __m256i v_four  = _mm256_set1_epi8(4);
+
+    while (ptr + 32 <= end) {
+        __m256i chunk   = _mm256_loadu_si256((const __m256i *) ptr);
+        __m256i space   = _mm256_cmpeq_epi8(chunk, v_space);
+        __m256i shifted = _mm256_sub_epi8(chunk, v_tab);
+        __m256i ctrl    = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, v_four), shifted);
+        uint32_t mask   = (uint32_t) _mm256_movemask_epi8(_mm256_or_si256(space, ctrl));
+
+        if (mask != 0xFFFFFFFFu)
+            return ptr + __builtin_ctz(~mask);
+        ptr += 32;
+    }
+#elif defined(__SSE2__)
+    const __m128i v_space = _mm_set1_epi8(' ');
+    const __m128i v_tab   = _mm_set1_epi8('\t');
+    const __m128i v_four  = _mm_set1_epi8(4);
+
+    while (ptr + 16 <= end) {
+        __m128i chunk   = _mm_loadu_si128((const __m128i *) ptr);
+        __m128i space   = _mm_cmpeq_epi8(chunk, v_space);
+        __m128i shifted = _mm_sub_epi8(chunk, v_tab);
+        __m128i ctrl    = _mm_cmpeq_epi8(_mm_min_epu8(shifted, v_four), shifted);
+        uint32_t mask   = (uint32_t) _mm_movemask_epi8(_mm_or_si128(space, ctrl));
+
+        if (mask != 0xFFFFu)
+            return ptr + __builtin_ctz(~mask & 0xFFFFu);
+        ptr += 16;
+    }
+#endif
+    while (ptr < end && isspace((unsigned char) *ptr))
+        ptr++;
+    return ptr;
+}
 
-        // Skip whitespace
-        if (isspace(c)) {
-            ptr++;
-            continue;
-        }
+/*
+ * Advance ptr past a run of identifier-continue characters. The AVX2 path
+ * classifies via the nibble bitmap (pshufb needs SSSE3+, so the plain SSE2
+ * build keeps the table-driven scalar loop, which already beats the old
+ * isalnum + strchr combination).
+ */
+static const char *scan_identifier_wide(const char *ptr, const char *end)
+{
+#if defined(__AVX2__)
+    const __m256i bitmap = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i *) ident_nibble_bitmap));
+    const __m256i powers = _mm256_broadcastsi128_si256(
+        _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0));
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+
+    while (ptr + 32 <= end) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i *) ptr);
+        __m256i rows  = _mm256_shuffle_epi8(bitmap, _mm256_and_si256(chunk, low_mask));
+        __m256i hi    = _mm256_and_si256(_mm256_srli_epi16(chunk, 4), low_mask);
+        __m256i bits  = _mm256_shuffle_epi8(powers, hi);
+
+        __m256i matched = _mm256_cmpeq_epi8(_mm256_and_si256(rows, bits), bits);
+        __m256i empty   = _mm256_cmpeq_epi8(bits, _mm256_setzero_si256());
+        uint32_t mask   = (uint32_t) _mm256_movemask_epi8(_mm256_andnot_si256(empty, matched));
+
+        if (mask != 0xFFFFFFFFu)
+            return ptr + __builtin_ctz(~mask);
+        ptr += 32;
+    }
+#endif
+    while (ptr < end && IDENT_CONT_TABLE[(unsigned char) *ptr])
+        ptr++;
+    return ptr;
+}
 
-        // LPAREN
-        if (c == '(') {
-            Token tok = {
-                .type = TOKEN_LPAREN,.value =
-                    (char *) ptr,.value_len = 1
-            };
-            arena_vec_push(&tokens, &tok, arena);
-            ptr++;
-            continue;
-        }
+void lex_init(LexState *ls, const char *source, size_t source_len)
+{
+    ls->ptr = source;
+    ls->end = source + source_len;
+}
 
-        // RPAREN
-        if (c == ')') {
-            Token tok = {
-                .type = TOKEN_RPAREN,.value =
-                    (char *) ptr,.value_len = 1
-            };
-            arena_vec_push(&tokens, &tok, arena);
-            ptr++;
-            continue;
-        }
+Token lex_next(LexState *ls)
+{
+    if (!scan_tables_ready)
+        build_scan_tables();
 
-        // Skip line comments (; until newline)
-        if (c == ';') {
-            while (++ptr < end && *ptr != '\n');
-            continue;
-        }
+    const char *ptr = ls->ptr;
+    const char *end = ls->end;
 
-        // QUOTE OPERATOR
-        if (c == '\'') {
-            Token tok = {
-                .type = TOKEN_QUOTE,.value =
-                    (char *) ptr,.value_len = 1
-            };
-            arena_vec_push(&tokens, &tok, arena);
-            ptr++;
-            continue;
-        }
+    while (ptr < end) {
+        // Skip whitespace runs 32/16 bytes at a time
+        ptr = skip_whitespace_wide(ptr, end);
+        if (ptr >= end)
+            break;
 
-        // COMMA OPERATOR
-        if (c == ',') {
+        char c = *ptr;
+
+        switch (CHAR_KIND[(unsigned char) c]) {
+
+        case CK_PUNCT: {
             Token tok = {
-                .type = TOKEN_COMMA,
-                .value =(char *) ptr,
+                .type = PUNCT_TOKEN[(unsigned char) c],
+                .value = (char *) ptr,
                 .value_len = 1
             };
-            arena_vec_push(&tokens, &tok, arena);
-            ptr++;
-            continue;
+            ls->ptr = ptr + 1;
+            return tok;
         }
 
-        // BACKQUOTE OPERATOR
-        if (c == '`') {
-            Token tok = {
-                .type = TOKEN_BACKQUOTE,
-                .value =(char *) ptr,
-                .value_len = 1
-            };
-            arena_vec_push(&tokens, &tok, arena);
-            ptr++;
+        // Skip line comments (; until newline); memchr is vectorized by libc
+        case CK_COMMENT: {
+            const char *nl = memchr(ptr, '\n', (size_t) (end - ptr));
+            ptr = nl ? nl + 1 : end;
             continue;
         }
 
-        // STRING
-        if (c == '"') {
+        case CK_STRING: {
             const char *start = ptr++;
             while (ptr < end && *ptr != '"') {
                 if (*ptr == '\\' && (ptr + 1 < end))
@@ -113,23 +235,29 @@ Vec *lex_tokens(const char *source, size_t source_len, Arena** arena)
                     .value = (char *) start,
                     .value_len = (size_t) (ptr - start + 1)
                 };
-                arena_vec_push(&tokens, &tok, arena);
-                ptr++;
+                ls->ptr = ptr + 1;
+                return tok;
             } else {
                 Token tok = {
                     .type = TOKEN_ERROR,
                     .value = (char *) start,
                     .value_len = (size_t) (ptr - start)
                 };
-                arena_vec_push(&tokens, &tok, arena);
+                ls->ptr = ptr;
+                return tok;
             }
-
-            continue;
         }
 
-        // INTEGER
-        if (isdigit(c) || ((c == '-' || c == '+') && ptr + 1 < end &&
-                           (isdigit(ptr[1]) || ptr[1] == '.'))) {
+        case CK_SIGN:
+            /* A sign is a number only when a digit or '.' follows;
+             * otherwise '-' / '+' are ordinary identifiers. */
+            if (ptr + 1 >= end ||
+                (CHAR_KIND[(unsigned char) ptr[1]] != CK_DIGIT &&
+                 ptr[1] != '.')) {
+                goto identifier;
+            }
+            /* fallthrough */
+        case CK_DIGIT: {
             const char *start = ptr;
             bool is_float = false;
 
@@ -137,14 +265,14 @@ Vec *lex_tokens(const char *source, size_t source_len, Arena** arena)
                 ptr++;
             }
 
-            while (ptr < end && isdigit(*ptr))
+            while (ptr < end && CHAR_KIND[(unsigned char) *ptr] == CK_DIGIT)
                 ptr++;
 
             if (ptr < end && *ptr == '.') {
                 is_float = true;
                 ptr++;
 
-                while (ptr < end && isdigit(*ptr))
+                while (ptr < end && CHAR_KIND[(unsigned char) *ptr] == CK_DIGIT)
                     ptr++;
             }
 
@@ -156,8 +284,9 @@ Vec *lex_tokens(const char *source, size_t source_len, Arena** arena)
                     ptr++;
                 }
 
-                if (ptr < end && isdigit(*ptr)) {
-                    while (ptr < end && isdigit(*ptr))
+                if (ptr < end && CHAR_KIND[(unsigned char) *ptr] == CK_DIGIT) {
+                    while (ptr < end &&
+                           CHAR_KIND[(unsigned char) *ptr] == CK_DIGIT)
                         ptr++;
                 } else {
                     ptr = start;
@@ -170,67 +299,248 @@ Vec *lex_tokens(const char *source, size_t source_len, Arena** arena)
                 .value = (char *) start,
                 .value_len = (size_t) (ptr - start),
             };
-            arena_vec_push(&tokens, &tok, arena);
-            continue;
+            ls->ptr = ptr;
+            return tok;
         }
 
         // UNINTERNED SYMBOL (#:foo)
-        if (c == '#' && ptr + 1 < end && ptr[1] == ':') {
-            const char *start = ptr;
-            ptr += 2;
-            if (ptr < end && (isalpha(*ptr) || IDENTIFIER_CHAR_TABLE[(unsigned char)*ptr])) {
-                while (ptr < end && (isalnum(*ptr) || 
-                                     strchr("!@$%^&*-+=<>/?:._~", *ptr))) {
-                    ptr++;
+        case CK_HASH:
+            if (ptr + 1 < end && ptr[1] == ':') {
+                const char *start = ptr;
+                ptr += 2;
+                if (ptr < end && IDENT_START_TABLE[(unsigned char) *ptr]) {
+                    ptr = scan_identifier_wide(ptr, end);
+                    Token tok = {
+                        .type = TOKEN_UNINTERNED_SYMBOL,
+                        .value = (char *) start,
+                        .value_len = (size_t) (ptr - start)
+                    };
+                    ls->ptr = ptr;
+                    return tok;
                 }
-                Token tok = {
-                    .type = TOKEN_UNINTERNED_SYMBOL,
-                    .value = (char *) start,
-                    .value_len = (size_t)(ptr - start)
-                };
-                arena_vec_push(&tokens, &tok, arena);
-                continue;
+                ptr = start;
             }
-        }
+            goto identifier;
 
+        case CK_SPACE:
+            /* The wide skip consumed the run; be safe regardless. */
+            ptr++;
+            continue;
 
+        case CK_IDENT:
         identifier:
-        c = *ptr;
-        // IDENTIFIER
-        if (isalpha(c) || IDENTIFIER_CHAR_TABLE[(unsigned char)c]) {
-            const char *start = ptr;
-            while (ptr < end && (isalnum(*ptr)
-                                 || IDENTIFIER_CHAR_TABLE[(unsigned char)*ptr])) {
-                ptr++;
+            if (IDENT_START_TABLE[(unsigned char) *ptr]) {
+                const char *start = ptr;
+                ptr = scan_identifier_wide(ptr, end);
+                Token tok = {
+                    .type = TOKEN_IDENTIFIER,
+                    .value = (char *) start,
+                    .value_len = (size_t) (ptr - start)
+                };
+                ls->ptr = ptr;
+                return tok;
             }
+            /* fallthrough */
+        case CK_ERROR:
+        default: {
             Token tok = {
-                .type = TOKEN_IDENTIFIER,
-                .value = (char *) start,
-                .value_len = (size_t) (ptr - start)
+                .type = TOKEN_ERROR,
+                .value = (char *) ptr,
+                .value_len = 1
             };
-            arena_vec_push(&tokens, &tok, arena);
-            continue;
+            ls->ptr = ptr + 1;
+            return tok;
         }
 
-        Token tok = {
-            .type = TOKEN_ERROR,
-            .value = (char *) ptr,
-            .value_len = 1
-        };
-        arena_vec_push(&tokens, &tok, arena);
-        ptr++;
+        }
+    }
+
+    ls->ptr = end;
+    Token eof = { .type = TOKEN_EOF, .value = (char *) end, .value_len = 0 };
+    return eof;
+}
+
+Vec *lex_tokens(const char *source, size_t source_len, Arena** arena)
+{
+    Vec *tokens = arena_vec_new(arena, sizeof(PackedToken), 64);
+    if (!tokens) return NULL;
+
+    LexState ls;
+    lex_init(&ls, source, source_len);
+
+    for (;;) {
+        Token tok = lex_next(&ls);
+        if (tok.type == TOKEN_EOF)
+            break;
+        PackedToken packed = token_pack(tok, source);
+        arena_vec_push(&tokens, &packed, arena);
     }
 
     return tokens;
 }
 
-Token vec_get_token(const Vec *v_ptr, size_t idx)
+/* ----------------- Parallel chunked lexing ----------------- */
+
+/*
+ * Tokens are context-free except for string literals and ;-comments, so
+ * any newline outside both is a safe place to cut the buffer: chunks
+ * can then be lexed independently and the token runs spliced back in
+ * source order. The cut scan is a single cheap pass that tracks only
+ * string/comment state (comments end at the newline; strings may span
+ * lines, which is why a bare newline search is not enough).
+ */
+
+#define LEX_MAX_THREADS 16
+
+static size_t find_cuts(const char *src, size_t len, size_t want,
+                        const char **cuts)
+{
+    const char *end = src + len;
+    size_t target = len / want;
+    const char *goal = src + target;
+    bool in_string = false;
+    bool in_comment = false;
+
+    size_t n = 1;
+    cuts[0] = src;
+
+    for (const char *p = src; p < end && n < want; p++) {
+        char c = *p;
+        if (in_string) {
+            if (c == '\\' && p + 1 < end) p++;          /* skip escape */
+            else if (c == '"') in_string = false;
+            continue;
+        }
+        if (in_comment) {
+            if (c == '\n') in_comment = false;
+            else continue;
+        } else if (c == '"') {
+            in_string = true;
+            continue;
+        } else if (c == ';') {
+            in_comment = true;
+            continue;
+        }
+
+        if (c == '\n' && p + 1 >= goal && p + 1 < end) {
+            cuts[n++] = p + 1;
+            goal = p + 1 + target;
+        }
+    }
+    return n;
+}
+
+typedef struct LexJob {
+    const char *base;   ///< Start of the whole source (offset origin)
+    const char *start;
+    const char *end;
+    Arena *arena;       ///< Thread-private token storage
+    Vec *tokens;
+    bool ok;
+} LexJob;
+
+static void *lex_job_run(void *argp)
+{
+    LexJob *job = (LexJob *) argp;
+    Arena *cursor = job->arena;
+
+    Vec *tokens = arena_vec_new(&cursor, sizeof(PackedToken), 1024);
+    if (!tokens) return NULL;
+
+    LexState ls;
+    ls.ptr = job->start;
+    ls.end = job->end;
+
+    for (;;) {
+        Token tok = lex_next(&ls);
+        if (tok.type == TOKEN_EOF)
+            break;
+        PackedToken packed = token_pack(tok, job->base);
+        if (arena_vec_push(&tokens, &packed, &cursor) != 0)
+            return NULL;
+    }
+
+    job->tokens = tokens;
+    job->ok = true;
+    return NULL;
+}
+
+Vec *lex_tokens_parallel(const char *source, size_t source_len,
+                         size_t nthreads, Arena **arena)
+{
+    if (nthreads > LEX_MAX_THREADS)
+        nthreads = LEX_MAX_THREADS;
+    if (nthreads <= 1 || source_len < LEX_PARALLEL_MIN_BYTES)
+        return lex_tokens(source, source_len, arena);
+
+    /* The scan tables must exist before workers race to use them. */
+    if (!scan_tables_ready)
+        build_scan_tables();
+
+    const char *cuts[LEX_MAX_THREADS];
+    size_t nchunks = find_cuts(source, source_len, nthreads, cuts);
+    if (nchunks <= 1)
+        return lex_tokens(source, source_len, arena);
+
+    LexJob jobs[LEX_MAX_THREADS] = { 0 };
+    pthread_t threads[LEX_MAX_THREADS];
+    size_t spawned = 0;
+
+    for (size_t i = 0; i < nchunks; i++) {
+        jobs[i].base = source;
+        jobs[i].start = cuts[i];
+        jobs[i].end = (i + 1 < nchunks) ? cuts[i + 1] : source + source_len;
+        /* Sized so a typical chunk never chains a second link. */
+        size_t span = (size_t) (jobs[i].end - jobs[i].start);
+        jobs[i].arena = arena_create(sizeof(Vec) + span / 2 * sizeof(PackedToken) + 4096);
+        if (!jobs[i].arena) goto fail;
+    }
+
+    for (; spawned < nchunks; spawned++) {
+        if (pthread_create(&threads[spawned], NULL, lex_job_run,
+                           &jobs[spawned]) != 0)
+            break;
+    }
+    for (size_t i = 0; i < spawned; i++)
+        pthread_join(threads[i], NULL);
+
+    if (spawned < nchunks) goto fail;
+
+    size_t total = 0;
+    for (size_t i = 0; i < nchunks; i++) {
+        if (!jobs[i].ok) goto fail;
+        total += vec_len(jobs[i].tokens);
+    }
+
+    /* Splice the per-thread runs, in source order, into one vector. */
+    Vec *all = arena_vec_new(arena, sizeof(PackedToken), total ? total : 1);
+    if (!all) goto fail;
+    char *dst = (char *) (all + 1);
+    for (size_t i = 0; i < nchunks; i++) {
+        size_t bytes = vec_len(jobs[i].tokens) * sizeof(PackedToken);
+        memcpy(dst, jobs[i].tokens + 1, bytes);
+        dst += bytes;
+        arena_free(jobs[i].arena);
+        jobs[i].arena = NULL;
+    }
+    all->elem_num = total;
+    all->bump_ptr = dst;
+    return all;
+
+fail:
+    for (size_t i = 0; i < nchunks; i++)
+        arena_free(jobs[i].arena);
+    /* Threads are a fast path, not a requirement. */
+    return lex_tokens(source, source_len, arena);
+}
+
+Token vec_get_token(const Vec *v_ptr, size_t idx, const char *source)
 {
     if (!v_ptr || idx >= v_ptr->elem_num) {
         Token error_token = { 0 };
         return error_token;
     }
-    return *(Token *) ((char *) (v_ptr + 1) + (idx * v_ptr->elem_size));
+    return token_unpack(vec_PackedToken_at(v_ptr, idx), source);
 }
 
 /* ----------------------- DEBUGGING ------------------- */
@@ -314,6 +624,12 @@ void print_type(TokenType type)
             printf("TOKEN_ERROR");
             break;
         }
+
+    case TOKEN_EOF:
+        {
+            printf("TOKEN_EOF");
+            break;
+        }
     }
 
 
@@ -334,7 +650,7 @@ void print_token(Token token)
     fprintf(stderr, "\n");
 }
 
-void print_token_vec(Vec *tokens)
+void print_token_vec(Vec *tokens, const char *source)
 {
     if (!tokens) {
         fprintf(stderr, "Error: NULL token vector\n");
@@ -342,7 +658,7 @@ void print_token_vec(Vec *tokens)
     }
 
     for (size_t i = 0; i < vec_len(tokens); i++) {
-        Token token = vec_get_token(tokens, i);
+        Token token = vec_get_token(tokens, i, source);
         print_token(token);
     }
 }
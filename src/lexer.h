@@ -6,6 +6,7 @@
 #define LEXER_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "vec.h"
 #include "arena.h"
@@ -29,7 +30,8 @@ typedef enum {
     TOKEN_UNINTERNED_SYMBOL,    ///< Especially used in macro to not pollute 
                                 ///     the local symtab and prevent unwanted shadowing
     TOKEN_ERROR,                ///< Invalid or unrecognized token
-    TOKEN_IGNORE                ///< This is the type of the parenthesis after the parsing
+    TOKEN_IGNORE,               ///< This is the type of the parenthesis after the parsing
+    TOKEN_EOF                   ///< End of the source buffer (streaming lexer only)
 } TokenType;
 
 /**
@@ -44,10 +46,82 @@ typedef struct {
     char *value;                ///< Pointer to the token's value (points into the original source)
 } Token;
 
+/**
+ * @struct PackedToken
+ * @brief Compact stored form of a Token.
+ *
+ * Every token points into the single source buffer, so the token vector
+ * only needs a 32-bit byte offset plus the length and type packed into
+ * a second word — 8 bytes instead of 24, tripling the tokens per cache
+ * line in the parser's scan loop. Lengths occupy the low 24 bits; the
+ * lexer's atom rules cannot produce a single token past that, and
+ * sources are capped at 4 GB by the offset width.
+ */
+typedef struct {
+    uint32_t offset;            ///< Byte offset of the token text in the source
+    uint32_t len_type;          ///< Length in the low 24 bits, TokenType in the high 8
+} PackedToken;
+
+/**
+ * @brief Pack a token for vector storage relative to @p source.
+ */
+static inline PackedToken token_pack(Token tok, const char *source)
+{
+    PackedToken p = {
+        .offset = (uint32_t) (tok.value - source),
+        .len_type = (uint32_t) tok.value_len | ((uint32_t) tok.type << 24)
+    };
+    return p;
+}
+
+/**
+ * @brief Expand a stored token back to the pointer form.
+ */
+static inline Token token_unpack(PackedToken p, const char *source)
+{
+    Token tok = {
+        .type = (TokenType) (p.len_type >> 24),
+        .value_len = p.len_type & 0xFFFFFFu,
+        .value = (char *) source + p.offset
+    };
+    return tok;
+}
+
+
+/**
+ * @struct LexState
+ * @brief Cursor over the source buffer for the pull-based streaming lexer.
+ */
+typedef struct {
+    const char *ptr;            ///< Current scan position
+    const char *end;            ///< One past the last source byte
+} LexState;
+
 
 /* ------------------------- Lexer ---------------------- */
 
 
+/**
+ * @brief Initialize a streaming lexer cursor over a source buffer.
+ *
+ * @param ls Cursor to initialize.
+ * @param source Pointer to the input source code.
+ * @param source_len Length of the input source code.
+ */
+void lex_init(LexState *ls, const char *source, size_t source_len);
+
+/**
+ * @brief Scan and return the next token, advancing the cursor.
+ *
+ * Tokens point into the original source buffer exactly as with
+ * `lex_tokens`; no memory is allocated. Returns a TOKEN_EOF token once
+ * the buffer is exhausted.
+ *
+ * @param ls Cursor previously set up with `lex_init`.
+ * @return Token The next token in the stream.
+ */
+Token lex_next(LexState *ls);
+
 /**
  * @brief Lexes the input source code into a vector of tokens.
  *
@@ -57,19 +131,41 @@ typedef struct {
  *
  * @param source Pointer to the input source code.
  * @param source_len Length of the input source code.
- * @return Vec* A vector of tokens, or NULL if memory allocation fails.
+ * @return Vec* A vector of PackedToken, or NULL if memory allocation fails.
  */
 Vec *lex_tokens(const char *source, size_t source_len, Arena** arena);
 
+/// Sources below this size are lexed sequentially: thread start-up and
+/// the boundary scan cost more than they save on small buffers.
+#define LEX_PARALLEL_MIN_BYTES (1u << 20)
+
+/**
+ * @brief Lex a source buffer on up to @p nthreads worker threads.
+ *
+ * The buffer is split at safe top-level boundaries — a newline outside
+ * string literals and `;` comments — so each chunk lexes independently;
+ * the per-thread token runs are then spliced back in source order. The
+ * result is identical to `lex_tokens` and falls back to it for small
+ * inputs, a single thread, or when threads cannot be started.
+ *
+ * @param source Pointer to the input source code.
+ * @param source_len Length of the input source code.
+ * @param nthreads Desired worker count (clamped; <=1 means sequential).
+ * @return Vec* A vector of PackedToken, or NULL if memory allocation fails.
+ */
+Vec *lex_tokens_parallel(const char *source, size_t source_len,
+                         size_t nthreads, Arena** arena);
+
 
 /**
- * @brief Retrieves a token from a vector of tokens by index.
+ * @brief Retrieves a token from a vector of packed tokens by index.
  *
- * @param v_ptr Pointer to the vector of tokens.
+ * @param v_ptr Pointer to the vector of packed tokens.
  * @param idx Index of the token to retrieve.
- * @return Token The token at the specified index.
+ * @param source The source buffer the tokens were lexed from.
+ * @return Token The token at the specified index, in pointer form.
  */
-Token vec_get_token(const Vec * v_ptr, size_t idx);
+Token vec_get_token(const Vec * v_ptr, size_t idx, const char *source);
 
 
 /* ------------------- Debugging --------------------- */
@@ -83,9 +179,10 @@ void print_token(Token token);
 
 /**
  * @brief Print all tokens in a vector to stderr.
- * @param tokens Pointer to the token vector. If NULL, prints error message.
+ * @param tokens Pointer to the packed token vector. If NULL, prints error message.
+ * @param source The source buffer the tokens were lexed from.
  */
-void print_token_vec(Vec * tokens);
+void print_token_vec(Vec * tokens, const char *source);
 
 
 #endif                          // LEXER_H
@@ -6,13 +6,19 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <time.h>
+#include <unistd.h>
 
 #include "lexer.h"
 #include "readfile.h"
 #include "src/arena.h"
 #include "vec.h"
 #include "parser.h"
+#include "passes.h"
 #include "eval.h"
+#include "symtab.h"
+#include "image.h"
+#include "repl.h"
+#include "stats.h"
 
 /* --------------------- Main Function --------------------- */
 
@@ -20,8 +26,16 @@ int main(int argc, char **argv)
 {
     clock_t start = clock();
 
+    /* Instrumented builds report on exit and on SIGUSR1. */
+    WISP_STATS_INSTALL();
+
+    /* No file: interactive session with persistent state. */
+    if (argc == 1) {
+        return repl_run(stdin, stdout);
+    }
     if (argc != 2) {
-        fprintf(stderr, "Usage: %s <file>\n", argv[0]);
+        fprintf(stderr, "Usage: %s [file]\n"
+                "With no file, starts an interactive REPL.\n", argv[0]);
         return -1;
     }
 
@@ -34,30 +48,102 @@ int main(int argc, char **argv)
     size_t initial_arena_size = (file->size > 1024*1024) ? file->size * 2 : 2 * 1024 * 1024;
     Arena* global_arena = arena_create(initial_arena_size);
 
-    printf("=== Lexing ===\n");
-    Vec *tokens = lex_tokens(file->data, file->size, &global_arena);
-    if (!tokens) {
-        fprintf(stderr, "lex_tokens: failed to lex tokens\n");
-        filebuffer_free(file);
-        return -1;
-    }
-    printf("Lexed %zu tokens", vec_len(tokens));
-
     if (!global_arena) {
         fprintf(stderr, "Failed to create global memory arena.\n");
         return -1;
     }
-    ConsList* program_ast = parse_program(tokens, &global_arena);
+
+    ConsList* program_ast = image_load(argv[1], &global_arena);
+    if (program_ast) {
+        printf("=== Loaded precompiled AST image ===\n");
+    } else {
+        if (file->size >= LEX_PARALLEL_MIN_BYTES) {
+            /* Multi-megabyte sources: lex chunks on a thread pool, then
+             * parse the spliced token vector. */
+            printf("=== Parsing (parallel lex) ===\n");
+            long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+            WISP_STAGE_BEGIN(WISP_STAGE_LEX);
+            Vec* tokens = lex_tokens_parallel(file->data, file->size,
+                                              ncpu > 0 ? (size_t) ncpu : 1,
+                                              &global_arena);
+            WISP_STAGE_END(WISP_STAGE_LEX);
+            WISP_STAGE_BEGIN(WISP_STAGE_PARSE);
+            program_ast = tokens ? parse_program(tokens, file->data, &global_arena) : NULL;
+            WISP_STAGE_END(WISP_STAGE_PARSE);
+        } else {
+            printf("=== Parsing (streaming) ===\n");
+            /* Lexing is fused into the parse here; it counts as parse. */
+            WISP_STAGE_BEGIN(WISP_STAGE_PARSE);
+            program_ast = parse_stream(file->data, file->size, &global_arena);
+            WISP_STAGE_END(WISP_STAGE_PARSE);
+        }
+        if (program_ast) {
+            WISP_STAGE_BEGIN(WISP_STAGE_PASSES);
+            expand_quasiquote(program_ast, &global_arena);
+            resolve_builtins(program_ast);
+            fold_constants(program_ast, &global_arena);
+            resolve_locals(program_ast, &global_arena);
+            vectorize_quoted(program_ast, &global_arena);
+            WISP_STAGE_END(WISP_STAGE_PASSES);
+            /* Best-effort cache refresh for the next startup; the image
+             * carries the resolved heads and vectorized quoted data. */
+            image_save(argv[1], program_ast);
+        }
+    }
     if (program_ast) {
         printf("\n=== Parsed AST ===\n");
         print_program(program_ast);
+        /* Strings and symbols were copied out during parsing; let the
+         * kernel reclaim the raw source pages before eval starts. */
+        filebuffer_discard(file);
     } else {
         fprintf(stderr, "Parsing failed.\n");
     }
 
+    /* Persistent arena holds the AST, intern pool and Symtab; eval
+     * temporaries go to a scratch arena reset between top-level forms. */
+    Arena* scratch_arena = NULL;
+
+    if (program_ast && program_ast->head) {
+        printf("=== Eval ===\n");
+        scratch_arena = arena_create(1024 * 1024);
+        Symtab* globals = symtab_new(NULL, &global_arena);
+        if (!scratch_arena || !globals) {
+            fprintf(stderr, "Execution failed.\n");
+        } else {
+            WISP_STAGE_BEGIN(WISP_STAGE_EVAL);
+            Cons* result = eval_program(program_ast, globals, &scratch_arena);
+            WISP_STAGE_END(WISP_STAGE_EVAL);
+            if (!result) {
+                fprintf(stderr, "Execution failed.\n");
+            }
+        }
+    }
+
+
+    /* Occupancy report for sizing initial_arena_size from data; the
+     * cursors may have advanced past filled links, so the numbers cover
+     * the links still reachable from here. */
+    Arena* reports[2] = { global_arena, scratch_arena };
+    const char* report_names[2] = { "global", "scratch" };
+    for (int i = 0; i < 2; i++) {
+        ArenaStats stats;
+        arena_stats(reports[i], &stats);
+        size_t recycled = 0, reused = 0;
+        for (size_t k = 0; k < ARENA_NUM_CLASSES; k++) {
+            recycled += stats.recycled[k];
+            reused += stats.reused[k];
+        }
+        fprintf(stderr,
+                "Arena %s: %zu link(s), %zu/%zu bytes used, %zu wasted, "
+                "%zu blocks recycled, %zu reused\n",
+                report_names[i], stats.links, stats.allocated,
+                stats.capacity, stats.wasted, recycled, reused);
+    }
 
     printf("=== Cleanup ===\n");
     filebuffer_free(file);
+    arena_free(scratch_arena);
     arena_free(global_arena);
 
     clock_t end = clock();
@@ -3,8 +3,11 @@
 */
 
 #include "parser.h"
+#include "builtins.h"
 #include "lexer.h"
+#include "intern.h"
 #include "vec.h"
+#include "writer.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -13,6 +16,10 @@
 
 #define MAX_CONSECUTIVE_QUOTES 8 ///< This is the maximum number of nested quotes ''''...(value)
 
+/* Monomorphic worklist accessors for the printer (@see VEC_DEFINE). */
+typedef const Cons* ConsRef;
+VEC_DEFINE(ConsRef)
+
 /* ------------ Utilities (Pure Cons-Cell Logic) ------------ */
 
 Cons* make_atom(const void* data, size_t size, NodeType type, Arena** arena) {
@@ -75,19 +82,96 @@ Cons* parse_list(Cons** cursor, Arena** arena) {
 }
 
 
+/**
+ * @brief Convert a single atom token into its Cons cell.
+ *
+ * Shared between the Vec-based parser and the streaming parser so the
+ * literal conversion rules (overflow falling back to symbols, quote
+ * stripping on strings) live in one place.
+ */
+static Cons* atom_from_token(Token tok, Arena** arena) {
+    switch (tok.type) {
+        case TOKEN_INTEGER: {
+            char buf[32];
+            size_t len = tok.value_len < 31 ? tok.value_len : 31;
+            memcpy(buf, tok.value, len);
+            buf[len] = '\0';
+
+            errno = 0;
+            char* endptr = NULL;
+            long long val = strtoll(buf, &endptr, 10);
+
+            if (errno == ERANGE || endptr == buf || *endptr != '\0') {
+                SymRef ref;
+                if (intern_ref(&ref, tok.value, tok.value_len) != 0) return NULL;
+                return make_atom(&ref, sizeof(SymRef), NODE_ATOM_SYM, arena);
+            }
+            return make_atom(&val, sizeof(val), NODE_ATOM_INT, arena);
+        }
+
+        case TOKEN_FLOAT: {
+            char buf[64];
+            size_t len = tok.value_len < 63 ? tok.value_len : 63;
+            memcpy(buf, tok.value, len);
+            buf[len] = '\0';
+
+            errno = 0;
+            char* endptr = NULL;
+            long double val = strtold(buf, &endptr);
+
+            if (errno == ERANGE || endptr == buf || *endptr != '\0' || !isfinite(val)) {
+                SymRef ref;
+                if (intern_ref(&ref, tok.value, tok.value_len) != 0) return NULL;
+                return make_atom(&ref, sizeof(SymRef), NODE_ATOM_SYM, arena);
+            }
+            return make_atom(&val, sizeof(long double), NODE_ATOM_FLOAT, arena);
+        }
+
+        case TOKEN_STRING: {
+            const char* start = tok.value;
+            size_t len = tok.value_len;
+            if (len >= 2 && start[0] == '"' && start[len - 1] == '"') {
+                start++; len -= 2;
+            }
+            WispStr* s = wstr_new(start, len, arena);
+            if (!s) return NULL;
+            return make_atom(&s, sizeof(WispStr*), NODE_ATOM_STR, arena);
+        }
+
+        case TOKEN_UNINTERNED_SYMBOL: {
+            char* s = (char*)arena_alloc(arena, tok.value_len + 1);
+            if (!s) return NULL;
+            memcpy(s, tok.value, tok.value_len);
+            s[tok.value_len] = '\0';
+            return make_atom(&s, sizeof(char*), NODE_ATOM_UNINTERNED, arena);
+        }
+
+        case TOKEN_IDENTIFIER: {
+            SymRef ref;
+            if (intern_ref(&ref, tok.value, tok.value_len) != 0) return NULL;
+            return make_atom(&ref, sizeof(SymRef), NODE_ATOM_SYM, arena);
+        }
+
+        default:
+            return NULL;
+    }
+}
+
+
 /* --------------- Parser API ----------------- */
 
-ConsList* parse_sexpr(Vec* tokens, Arena** arena) {
+ConsList* parse_sexpr(Vec* tokens, const char* source, Arena** arena) {
     if (!tokens || !arena || !*arena || vec_len(tokens) == 0) {
         return NULL;
     }
+    if (intern_init(arena) != 0) return NULL;
 
     Cons* head = NULL;
     Cons* tail = NULL;
 
     const size_t ntok = vec_len(tokens);
     for (size_t i = 0; i < ntok; i++) {
-        Token tok = vec_get_token(tokens, i);
+        Token tok = vec_get_token(tokens, i, source);
         if (tok.type == TOKEN_IGNORE) continue;
 
         Cons* node = NULL;
@@ -101,70 +185,12 @@ ConsList* parse_sexpr(Vec* tokens, Arena** arena) {
                 node = make_shallow_atom(NODE_CLOSING_SEPARATOR, NULL, 0, arena);
             } break;
 
-            case TOKEN_INTEGER: {
-                char buf[32];
-                size_t len = tok.value_len < 31 ? tok.value_len : 31;
-                memcpy(buf, tok.value, len);
-                buf[len] = '\0';
-
-                errno = 0;
-                char* endptr = NULL;
-                long long val = strtoll(buf, &endptr, 10);
-
-                if (errno == ERANGE || endptr == buf || *endptr != '\0') {
-                    char* s = (char*)arena_alloc(arena, tok.value_len + 1);
-                    if (!s) return NULL;
-                    memcpy(s, tok.value, tok.value_len);
-                    s[tok.value_len] = '\0';
-                    node = make_atom(&s, sizeof(char*), NODE_ATOM_SYM, arena);
-                } else {
-                    node = make_atom(&val, sizeof(val), NODE_ATOM_INT, arena);
-                }
-            } break;
-
-            case TOKEN_FLOAT: {
-                char buf[64];
-                size_t len = tok.value_len < 63 ? tok.value_len : 63;
-                memcpy(buf, tok.value, len);
-                buf[len] = '\0';
-
-                errno = 0;
-                char* endptr = NULL;
-                long double val = strtold(buf, &endptr);
-
-                if (errno == ERANGE || endptr == buf || *endptr != '\0' || !isfinite(val)) {
-                    char* s = (char*)arena_alloc(arena, tok.value_len + 1);
-                    if (!s) return NULL;
-                    memcpy(s, tok.value, tok.value_len);
-                    s[tok.value_len] = '\0';
-                    node = make_atom(&s, sizeof(char*), NODE_ATOM_SYM, arena);
-                } else {
-                    node = make_atom(&val, sizeof(long double), NODE_ATOM_FLOAT, arena);
-                }
-            } break;
-
-            case TOKEN_STRING: {
-                const char* start = tok.value;
-                size_t len = tok.value_len;
-                if (len >= 2 && start[0] == '"' && start[len - 1] == '"') {
-                    start++; len -= 2;
-                }
-                char* s = (char*)arena_alloc(arena, len + 1);
-                if (!s) {
-                    return NULL;
-                }
-                memcpy(s, start, len);
-                s[len] = '\0';
-                node = make_atom(&s, sizeof(char*), NODE_ATOM_STR, arena);
-            } break;
-
-
-            case TOKEN_UNINTERNED_SYMBOL: {
-                char* s = (char*)arena_alloc(arena, tok.value_len + 1);
-                if (!s) return NULL;
-                memcpy(s, tok.value, tok.value_len);
-                s[tok.value_len] = '\0';
-                node = make_atom(&s, sizeof(char*), NODE_ATOM_UNINTERNED, arena);
+            case TOKEN_INTEGER:
+            case TOKEN_FLOAT:
+            case TOKEN_STRING:
+            case TOKEN_UNINTERNED_SYMBOL:
+            case TOKEN_IDENTIFIER: {
+                node = atom_from_token(tok, arena);
             } break;
 
             case TOKEN_QUOTE:{
@@ -179,16 +205,6 @@ ConsList* parse_sexpr(Vec* tokens, Arena** arena) {
                 node = make_shallow_atom(NODE_UNQUOTE, NULL, 0, arena);
             }break;
 
-            case TOKEN_IDENTIFIER: {
-                char* s = (char*)arena_alloc(arena, tok.value_len + 1);
-                if (!s) {
-                    return NULL;
-                }
-                memcpy(s, tok.value, tok.value_len);
-                s[tok.value_len] = '\0';
-                node = make_atom(&s, sizeof(char*), NODE_ATOM_SYM, arena);
-            } break;
-
             case TOKEN_ERROR:
             default: {
                 return NULL;
@@ -241,7 +257,7 @@ ConsList* parse_sexpr(Vec* tokens, Arena** arena) {
     return result;
 }
 
-ConsList* parse_program(Vec* tokens, Arena** arena) {
+ConsList* parse_program(Vec* tokens, const char* source, Arena** arena) {
     if (!tokens || !arena || !*arena) return NULL;
     if (vec_len(tokens) == 0) {
         ConsList* empty = (ConsList*)arena_alloc(arena, sizeof(ConsList));
@@ -249,7 +265,94 @@ ConsList* parse_program(Vec* tokens, Arena** arena) {
         cons_list_init(empty);
         return empty;
     }
-    return parse_sexpr(tokens, arena);
+    return parse_sexpr(tokens, source, arena);
+}
+
+
+/* --------------- Streaming Parser ----------------- */
+
+/**
+ * @brief Parse one expression whose first token is already in hand.
+ *
+ * Pulls further tokens from the lexer cursor as needed. Lists are built
+ * directly into their final ConsList — no separator cons cells and no
+ * shallow clones.
+ */
+static Cons* parse_expr_stream(LexState* ls, Token tok, Arena** arena) {
+    switch (tok.type) {
+        case TOKEN_LPAREN: {
+            ConsList* body = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+            if (!body) return NULL;
+            cons_list_init(body);
+
+            for (;;) {
+                Token t = lex_next(ls);
+                if (t.type == TOKEN_EOF) {
+                    fprintf(stderr, "Parsing Error: Unclosed parenthesis.\n");
+                    return NULL;
+                }
+                if (t.type == TOKEN_RPAREN) {
+                    return wrap_list(body, arena);
+                }
+
+                Cons* child = parse_expr_stream(ls, t, arena);
+                if (!child) return NULL;
+                cons_list_push_back(body, child);
+            }
+        }
+
+        case TOKEN_QUOTE:
+        case TOKEN_BACKQUOTE:
+        case TOKEN_COMMA: {
+            NodeType qt = (tok.type == TOKEN_QUOTE)     ? NODE_QUOTE
+                        : (tok.type == TOKEN_BACKQUOTE) ? NODE_QUASIQUOTE
+                        : NODE_UNQUOTE;
+
+            Token t = lex_next(ls);
+            if (t.type == TOKEN_EOF) {
+                fprintf(stderr, "Parsing Error: Dangling quote at end of input.\n");
+                return NULL;
+            }
+
+            Cons* inner = parse_expr_stream(ls, t, arena);
+            if (!inner) return NULL;
+            return make_atom(&inner, sizeof(Cons*), qt, arena);
+        }
+
+        case TOKEN_RPAREN: {
+            fprintf(stderr, "Parsing Error: Unexpected ')'.\n");
+            return NULL;
+        }
+
+        case TOKEN_ERROR:
+            return NULL;
+
+        default:
+            return atom_from_token(tok, arena);
+    }
+}
+
+ConsList* parse_stream(const char* source, size_t source_len, Arena** arena) {
+    if (!source || !arena || !*arena) return NULL;
+    if (intern_init(arena) != 0) return NULL;
+
+    LexState ls;
+    lex_init(&ls, source, source_len);
+
+    ConsList* program = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!program) return NULL;
+    cons_list_init(program);
+
+    for (;;) {
+        Token tok = lex_next(&ls);
+        if (tok.type == TOKEN_EOF) break;
+
+        Cons* expr = parse_expr_stream(&ls, tok, arena);
+        if (!expr) return NULL;
+        cons_list_push_back(program, expr);
+    }
+
+    return program;
 }
 
 
@@ -266,7 +369,7 @@ ConsList* parse_program(Vec* tokens, Arena** arena) {
  * @param stream The file stream to print to (e.g., stdout, stderr).
  * @param expr   A pointer to the root Cons cell of the S-expression to print.
  */
-static void print_expression(FILE* stream, const Cons* expr) {
+void print_expression(FILE* stream, const Cons* expr) {
     if (!stream) {
         return;
     }
@@ -284,38 +387,54 @@ static void print_expression(FILE* stream, const Cons* expr) {
         return;
     }
 
-    vec_push(&worklist, &expr);
+    /* Output is batched (@see writer.h): the whole expression becomes
+     * one write instead of one stdio call per atom, paren and space. */
+    Writer w;
+    if (writer_init(&w, 256) != 0) {
+        fprintf(stderr, "Fatal: Could not allocate memory for AST printing.\n");
+        vec_free(&worklist);
+        return;
+    }
+
+    vec_ConsRef_push(worklist, expr);
 
     while (vec_len(worklist) > 0) {
         const Cons* node;
-        vec_pop_get(worklist, &node);
+        vec_ConsRef_pop(worklist, &node);
 
         if (node == RPAREN_MARKER) {
-            fprintf(stream, ")");
+            writer_char(&w, ')');
             continue;
         }
         if (node == SPACE_MARKER) {
-            fprintf(stream, " ");
+            writer_char(&w, ' ');
             continue;
         }
         if (!node) {
-            fprintf(stream, "nil");
+            writer_str(&w, "nil");
             continue;
         }
 
         switch (node->type) {
             case NODE_ATOM_INT: {
-                fprintf(stream, "%lld", *(long long*)(node->car));
+                writer_int(&w, *(long long*)(node->car));
+                break;
+            }
+
+            case NODE_ATOM_FLOAT: {
+                writer_float(&w, *(const long double*)(node->car));
                 break;
             }
 
             case NODE_ATOM_SYM: {
-                fprintf(stream, "%s", *(char**)(node->car));
+                writer_str(&w, ((const SymRef*)(node->car))->name);
                 break;
             }
 
             case NODE_ATOM_STR: {
-                fprintf(stream, "\"%s\"", *(char**)(node->car));
+                writer_char(&w, '"');
+                writer_str(&w, (*(WispStr* const*)(node->car))->bytes);
+                writer_char(&w, '"');
                 break;
             }
 
@@ -325,56 +444,77 @@ static void print_expression(FILE* stream, const Cons* expr) {
                 char prefix = (node->type == NODE_QUOTE) ? '\''
                             : (node->type == NODE_QUASIQUOTE) ? '`'
                             : ',';
-                fprintf(stream, "%c", prefix);
+                writer_char(&w, prefix);
 
                 const Cons* inner_expr = *(const Cons**)(node->car);
 
-                vec_push(&worklist, &inner_expr);
+                vec_ConsRef_push(worklist, inner_expr);
                 break;
             }
 
             case NODE_ATOM_UNINTERNED:{
-                fprintf(stream, "%s", *(char**)(node->car));
+                writer_str(&w, *(char**)(node->car));
                 break;
             }
 
             case NODE_NIL: {
-                fprintf(stream, "nil");
+                writer_str(&w, "nil");
+                break;
+            }
+
+            case NODE_LAMBDA: {
+                writer_str(&w, "#<lambda>");
+                break;
+            }
+
+            case NODE_BUILTIN: {
+                writer_str(&w, builtin_type_names[*(const BuiltinType*)(node->car)]);
+                break;
+            }
+
+            case NODE_LOCAL_REF: {
+                writer_str(&w, ((const LocalRef*)(node->car))->name);
                 break;
             }
 
             case NODE_OPENING_SEPARATOR:
             case NODE_CLOSING_SEPARATOR: {
-                fprintf(stream, "<PARSER_ARTIFACT>");
+                writer_str(&w, "<PARSER_ARTIFACT>");
                 break;
             }
 
+            /* A lambda signature prints as its parameter list; the
+             * capture plan is evaluator bookkeeping. */
+            case NODE_LAMBDA_SIG:
             case NODE_LIST: {
-                fprintf(stream, "(");
-                vec_push(&worklist, &RPAREN_MARKER);
+                writer_char(&w, '(');
+                vec_ConsRef_push(worklist, RPAREN_MARKER);
 
-                const ConsList* sublist = *(const ConsList**)(node->car);
+                const ConsList* sublist = node->type == NODE_LAMBDA_SIG
+                    ? (*(const LambdaSig* const*)(node->car))->params
+                    : *(const ConsList**)(node->car);
                 if (sublist && sublist->head) {
                     Vec* children = vec_new(sizeof(const Cons*), sublist->length);
                     if (!children) {
                         fprintf(stderr, "Fatal: OOM during AST printing.\n");
+                        writer_destroy(&w);
                         vec_free(&worklist);
                         return;
                     }
 
                     for (const Cons* current = sublist->head; current != NULL; current = current->cdr) {
-                        vec_push(&children, &current);
+                        vec_ConsRef_push(children, current);
                     }
 
                     bool first_child = true;
                     while (vec_len(children) > 0) {
                         const Cons* child_node;
-                        vec_pop_get(children, &child_node);
+                        vec_ConsRef_pop(children, &child_node);
 
                         if (!first_child) {
-                            vec_push(&worklist, &SPACE_MARKER);
+                            vec_ConsRef_push(worklist, SPACE_MARKER);
                         }
-                        vec_push(&worklist, &child_node);
+                        vec_ConsRef_push(worklist, child_node);
                         first_child = false;
                     }
                     vec_free(&children);
@@ -382,15 +522,33 @@ static void print_expression(FILE* stream, const Cons* expr) {
                 break;
             }
 
+            case NODE_VECTOR_LIST: {
+                writer_char(&w, '(');
+                vec_ConsRef_push(worklist, RPAREN_MARKER);
+
+                const VecList* v = (const VecList*)(node->car);
+                for (size_t i = v->count; i-- > 0;) {
+                    vec_ConsRef_push(worklist, v->items[i]);
+                    if (i > 0) {
+                        vec_ConsRef_push(worklist, SPACE_MARKER);
+                    }
+                }
+                break;
+            }
+
             default: {
-                fprintf(stream, "<UNKNOWN_NODE_TYPE>");
+                writer_str(&w, "<UNKNOWN_NODE_TYPE>");
                 break;
             }
         }
     }
 
     vec_free(&worklist);
-    fprintf(stream, "\n");
+    writer_char(&w, '\n');
+    if (writer_flush(&w, stream) != 0) {
+        fprintf(stderr, "Fatal: Could not write AST dump.\n");
+    }
+    writer_destroy(&w);
 }
 
 void print_program(ConsList* program) {
@@ -6,11 +6,14 @@
 #define PARSER_H
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 #include <stdalign.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "arena.h"
+#include "intern.h"
 #include "vec.h"
 
 /* ------------------------ Node Types ------------------------ */
@@ -18,8 +21,8 @@
 typedef enum NodeType{
     NODE_ATOM_INT,          ///< car[] holds long long
     NODE_ATOM_FLOAT,        ///< car[] holds double
-    NODE_ATOM_SYM,          ///< car[] holds char* (symbol)
-    NODE_ATOM_STR,          ///< car[] holds char* (string)
+    NODE_ATOM_SYM,          ///< car[] holds SymRef (interned symbol, @see intern.h)
+    NODE_ATOM_STR,          ///< car[] holds WispStr* (string object)
     NODE_ATOM_UNINTERNED,   ///< car[] holds char* (uninterned symbol #:foo)
     NODE_LIST,              ///< car[] holds ConsList*
     NODE_QUOTE,             ///< car[] holds a ''' to quote
@@ -27,7 +30,12 @@ typedef enum NodeType{
     NODE_UNQUOTE,           ///< car[] holds a ',' to unquote
     NODE_CLOSING_SEPARATOR, ///< Parser artifact for ')'
     NODE_OPENING_SEPARATOR, ///< Parser artifact for '('
-    NODE_NIL                ///< car[] holds NULL
+    NODE_NIL,               ///< car[] holds NULL
+    NODE_LAMBDA,            ///< car[] holds Lambda (eval-time closure, @see eval.h)
+    NODE_BUILTIN,           ///< car[] holds BuiltinType (resolved call head, @see passes.h)
+    NODE_VECTOR_LIST,       ///< car[] holds VecList (contiguous proper list)
+    NODE_LOCAL_REF,         ///< car[] holds LocalRef (resolved parameter, @see passes.h)
+    NODE_LAMBDA_SIG         ///< car[] holds LambdaSig* (lambda with captures, @see passes.h)
 } NodeType;
 
 /* ------------------------ Cons Cells ------------------------ */
@@ -45,6 +53,66 @@ typedef struct {
     size_t length;      ///< Program lenght in cons cell
 } ConsList;
 
+/*
+ * Alternative proper-list layout: children as a contiguous arena array
+ * of Cons*, so iteration is a linear scan instead of a cdr pointer
+ * chase, and cdr is an O(1) view into the same array (items+1). Chosen
+ * at parse time for quoted data lists and by builtins that know their
+ * element count up front; call forms keep the cdr chain the structural
+ * walkers depend on.
+ */
+typedef struct VecList {
+    Cons** items;       ///< Contiguous array of children (NULL iff count == 0)
+    size_t count;
+} VecList;
+
+/*
+ * Parameter reference resolved by the locals pass (@see passes.h):
+ * depth activation records up the lexical chain, slot entries in. The
+ * canonical interned name is kept for diagnostics and printing. Same
+ * size as SymRef, so the rewrite happens in place.
+ */
+typedef struct LocalRef {
+    uint32_t depth;
+    uint32_t slot;
+    const char* name;
+} LocalRef;
+
+/*
+ * Free-variable capture plan computed by the locals pass (@see
+ * passes.h). A lambda whose body reads outer parameters gets its
+ * parameter-list node rewritten from NODE_LIST to NODE_LAMBDA_SIG: the
+ * payload keeps the original parameter list and adds, per captured
+ * variable, where its value sits at closure-creation time (depth
+ * activation records up from the creating frame, slot entries in). The
+ * evaluator copies those values into a flat array on the closure and
+ * binds them as extra slots after the parameters, so body references
+ * become plain depth-0 indexed loads instead of multi-record walks.
+ */
+typedef struct CaptureRef {
+    uint32_t depth;         ///< Records up from the creation-site frame
+    uint32_t slot;          ///< Slot index within that record
+} CaptureRef;
+
+typedef struct LambdaSig {
+    ConsList* params;       ///< Original NODE_ATOM_SYM parameter list
+    uint32_t cap_count;
+    CaptureRef caps[];      ///< One entry per captured variable
+} LambdaSig;
+
+/*
+ * String payload: byte count, cached FNV-1a hash (the symtab_hash /
+ * intern_hash convention) and the bytes inline in one arena block,
+ * NUL-terminated for C interop. NODE_ATOM_STR car[] holds a WispStr*,
+ * so equality is a hash compare plus one memcmp and length is a field
+ * read — no strlen/strcmp over the bytes on every check.
+ */
+typedef struct WispStr {
+    uint32_t len;       ///< Byte count, excluding the terminator
+    uint32_t hash;      ///< FNV-1a over the bytes
+    char bytes[];       ///< Contents, inline and NUL-terminated
+} WispStr;
+
 /* --------------------- Public API --------------------------- */
 
 /**
@@ -72,11 +140,13 @@ static inline Cons* make_shallow_atom(NodeType type, const char* p, size_t n, Ar
 Cons* parse_list(Cons** cursor, Arena** arena);
 
 /**
- * @brief Linearize a Vec<Token> into a flat Cons chain and parse one S-expression.
+ * @brief Linearize a Vec<PackedToken> into a flat Cons chain and parse one S-expression.
  * @retval ConsList* containing the parsed top-level form.
  *
+ * @note @p source is the buffer the tokens were lexed from; packed
+ *       tokens store offsets into it rather than pointers.
  */
-ConsList* parse_sexpr(Vec* tokens, Arena** arena);
+ConsList* parse_sexpr(Vec* tokens, const char* source, Arena** arena);
 
 /**
  * @brief Parses a vector of tokens containing multiple top-level S-expressions.
@@ -88,7 +158,18 @@ ConsList* parse_sexpr(Vec* tokens, Arena** arena);
  *       connected via the cdr of the head cons @see ConsList, and the final one is simply 
  *       pointed by the tail field of the ConsList* and posses a NULL pointer in cdr.
  */
-ConsList* parse_program(Vec* tokens, Arena** arena);
+ConsList* parse_program(Vec* tokens, const char* source, Arena** arena);
+
+/**
+ * @brief One-pass streaming parser: lex and parse directly from source.
+ *
+ * @note Pulls tokens on demand from the streaming lexer (@see lex_next)
+ *       and builds the final ConsList AST in a single pass — no
+ *       intermediate Vec<Token>, no separator cons cells, and no shallow
+ *       clones. Produces the same AST shape as parse_program and should
+ *       be preferred for large inputs.
+ */
+ConsList* parse_stream(const char* source, size_t source_len, Arena** arena);
 
 /* -------------------- Inline Utilities ---------------------- */
 
@@ -124,8 +205,29 @@ static inline Cons* wrap_list(ConsList* list, Arena** arena) {
     return make_atom(&list, sizeof(ConsList*), NODE_LIST, arena);
 }
 
+static inline Cons* make_vector_list(Cons** items, size_t count, Arena** arena) {
+    VecList v = { count ? items : NULL, count };
+    return make_atom(&v, sizeof(VecList), NODE_VECTOR_LIST, arena);
+}
+
 static inline bool is_sublist(const Cons* c) {
-    return c && c->type == NODE_LIST;
+    return c && (c->type == NODE_LIST || c->type == NODE_VECTOR_LIST);
+}
+
+static inline WispStr* wstr_new(const char* bytes, size_t len, Arena** arena) {
+    WispStr* s = (WispStr*)arena_alloc(arena, sizeof(WispStr) + len + 1);
+    if (!s) return NULL;
+    s->len = (uint32_t)len;
+    s->hash = intern_hash(bytes, len);
+    memcpy(s->bytes, bytes, len);
+    s->bytes[len] = '\0';
+    return s;
+}
+
+static inline bool wstr_eq(const WispStr* a, const WispStr* b) {
+    if (a == b) return true;
+    if (a->hash != b->hash || a->len != b->len) return false;
+    return memcmp(a->bytes, b->bytes, a->len) == 0;
 }
 
 /* ------------ Debugging ----------- */
@@ -141,4 +243,9 @@ static inline bool is_sublist(const Cons* c) {
  */
 void print_program(ConsList* program);
 
+/**
+ * @brief Print a single expression (with trailing newline) to @p stream.
+ */
+void print_expression(FILE* stream, const Cons* expr);
+
 #endif /* PARSER_H */
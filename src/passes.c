@@ -0,0 +1,831 @@
+/*
+ * @file passes.c
+ */
+#include <string.h>
+
+#include "passes.h"
+#include "builtins.h"
+#include "intern.h"
+
+static void resolve_expr(Cons* expr);
+
+static void resolve_chain(Cons* head) {
+    for (Cons* c = head; c; c = c->cdr) {
+        resolve_expr(c);
+    }
+}
+
+static bool sym_is(const Cons* c, const char* name) {
+    return c->type == NODE_ATOM_SYM &&
+           strcmp(((const SymRef*)c->car)->name, name) == 0;
+}
+
+static void resolve_expr(Cons* expr) {
+    if (!expr) return;
+
+    switch (expr->type) {
+        case NODE_LIST: {
+            ConsList* form = *(ConsList**)expr->car;
+            if (!form || !form->head) return;
+
+            Cons* head = form->head;
+
+            if (head->type == NODE_ATOM_SYM) {
+                /* (quote ...) is data all the way down. */
+                if (sym_is(head, "quote")) return;
+
+                /* Syntax slots must not be treated as call forms: the
+                 * define signature / lambda parameter list stay as-is,
+                 * the rest of the form is ordinary code. */
+                if (sym_is(head, "define") || sym_is(head, "lambda")) {
+                    if (head->cdr) resolve_chain(head->cdr->cdr);
+                    return;
+                }
+
+                const SymRef* ref = (const SymRef*)head->car;
+                const struct BuiltinName* b =
+                    find_builtin(ref->name, strlen(ref->name));
+                if (b) {
+                    /* In-place rewrite: the SymRef payload shrinks to
+                     * one BuiltinType byte, the chain stays intact. */
+                    head->type = NODE_BUILTIN;
+                    *(BuiltinType*)head->car = b->type;
+                    head->size = sizeof(BuiltinType);
+                }
+
+                resolve_chain(head->cdr);
+                return;
+            }
+
+            /* Computed operator, e.g. ((lambda (x) x) 1). */
+            resolve_chain(head);
+            return;
+        }
+
+        case NODE_QUOTE:
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE:
+            /* Quoted and template data: leave untouched. */
+            return;
+
+        default:
+            return;
+    }
+}
+
+void resolve_builtins(ConsList* program) {
+    if (!program) return;
+    resolve_chain(program->head);
+}
+
+/* ------------------ Local slot resolution ------------------ */
+
+/*
+ * Lambda invocation is the hottest path in the evaluator, and most of
+ * its cost used to be scope setup: a 16-slot hash table per call plus
+ * hashed probes up the parent chain per parameter read. This pass
+ * numbers each parameter to a (depth, slot) pair at parse time and
+ * rewrites references in place to NODE_LOCAL_REF, so calls can push a
+ * flat activation record (@see ActRec) and reads become two adds and a
+ * load. Bodies with internal defines are left unresolved: those calls
+ * keep the full Symtab so runtime bindings (and shadowing through them)
+ * behave exactly as before.
+ */
+
+#define LOCALS_MAX_CAPS 32  ///< Captures per lambda; overflow keeps the depth walk
+
+typedef struct LocalScope {
+    const struct LocalScope* up;
+    const Cons* params;     ///< Chain of parameter cells (may be NULL)
+    bool slotted;           ///< False: this frame keeps symbol lookups
+    /* Capture planning (slotted explicit-lambda frames only). */
+    bool capturing;         ///< Outer reads may be hoisted into captures
+    uint32_t nparams;       ///< Parameter count (capture slots start here)
+    uint64_t mutated;       ///< set!-targeted parameter bits (conservative)
+    CaptureRef* caps;       ///< Collected captures (LOCALS_MAX_CAPS entries)
+    uint32_t cap_count;
+} LocalScope;
+
+static bool expr_has_define(const Cons* e) {
+    if (e->type != NODE_LIST) return false;
+    const ConsList* form = *(ConsList* const*)e->car;
+    if (!form || !form->head) return false;
+
+    const Cons* head = form->head;
+    if (head->type == NODE_ATOM_SYM) {
+        if (sym_is(head, "define")) return true;
+        /* Quoted data is not code; a nested lambda's defines land in its
+         * own frame. */
+        if (sym_is(head, "quote") || sym_is(head, "lambda")) return false;
+    }
+    for (const Cons* c = head; c; c = c->cdr) {
+        if (expr_has_define(c)) return true;
+    }
+    return false;
+}
+
+bool lambda_body_has_define(const Cons* body) {
+    for (const Cons* form = body; form; form = form->cdr) {
+        if (expr_has_define(form)) return true;
+    }
+    return false;
+}
+
+static bool scope_find(const LocalScope* scope, const SymRef* ref,
+                       uint32_t* depth, uint32_t* slot,
+                       const LocalScope** owner) {
+    uint32_t d = 0;
+    for (const LocalScope* s = scope; s; s = s->up, d++) {
+        uint32_t i = 0;
+        for (const Cons* p = s->params; p; p = p->cdr, i++) {
+            if (p->type != NODE_ATOM_SYM) continue;
+            if (!sym_ref_eq((const SymRef*)p->car, ref)) continue;
+            /* Shadowing stops the search either way: an unslotted
+             * binding stays a symbol lookup. */
+            if (!s->slotted) return false;
+            *depth = d;
+            *slot = i;
+            *owner = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Conservatively collect which of a frame's parameters the body ever
+ * set!s. Captures are by value, so a mutated parameter must keep its
+ * depth-walk reference: every reader and writer has to keep hitting the
+ * one shared slot. The scan descends nested lambdas too — shadowing can
+ * only cause false positives, which just skip a capture opportunity.
+ */
+static void mutated_scan(const Cons* e, const Cons* params, uint64_t* mask) {
+    if (e->type != NODE_LIST) return;
+    const ConsList* form = *(ConsList* const*)e->car;
+    if (!form || !form->head) return;
+
+    const Cons* head = form->head;
+    if (head->type == NODE_ATOM_SYM) {
+        if (sym_is(head, "quote")) return;
+        if (sym_is(head, "set!") && head->cdr &&
+            head->cdr->type == NODE_ATOM_SYM) {
+            const SymRef* target = (const SymRef*)head->cdr->car;
+            uint32_t i = 0;
+            for (const Cons* p = params; p; p = p->cdr, i++) {
+                if (p->type == NODE_ATOM_SYM && i < 64 &&
+                    sym_ref_eq((const SymRef*)p->car, target)) {
+                    *mask |= UINT64_C(1) << i;
+                }
+            }
+        }
+    }
+    for (const Cons* c = head; c; c = c->cdr) {
+        mutated_scan(c, params, mask);
+    }
+}
+
+static uint64_t mutated_params(const Cons* body, const Cons* params) {
+    uint64_t mask = 0;
+    for (const Cons* form = body; form; form = form->cdr) {
+        mutated_scan(form, params, &mask);
+    }
+    return mask;
+}
+
+static void locals_expr(Cons* expr, LocalScope* scope, Arena** arena);
+
+static void locals_chain(Cons* head, LocalScope* scope, Arena** arena) {
+    for (Cons* c = head; c; c = c->cdr) {
+        locals_expr(c, scope, arena);
+    }
+}
+
+static void locals_expr(Cons* expr, LocalScope* scope, Arena** arena) {
+    switch (expr->type) {
+        case NODE_ATOM_SYM: {
+            const SymRef* ref = (const SymRef*)expr->car;
+            uint32_t depth, slot;
+            const LocalScope* owner;
+            if (!scope_find(scope, ref, &depth, &slot, &owner)) return;
+
+            /* An outer read from a capturing frame is hoisted into the
+             * closure's capture array: the reference becomes a depth-0
+             * slot past the parameters, filled at creation time (@see
+             * LambdaSig). Parameters the owner's body ever set!s keep
+             * the depth walk — a by-value copy would split them from
+             * the shared slot writes go to. */
+            if (depth > 0 && scope->capturing && slot < 64 &&
+                !((owner->mutated >> slot) & 1)) {
+                uint32_t k = 0;
+                while (k < scope->cap_count &&
+                       !(scope->caps[k].depth == depth - 1 &&
+                         scope->caps[k].slot == slot)) {
+                    k++;
+                }
+                if (k < LOCALS_MAX_CAPS) {
+                    if (k == scope->cap_count) {
+                        scope->caps[k] = (CaptureRef){ depth - 1, slot };
+                        scope->cap_count++;
+                    }
+                    LocalRef lr = { 0, scope->nparams + k, ref->name };
+                    expr->type = NODE_LOCAL_REF;
+                    memcpy(expr->car, &lr, sizeof(lr));
+                    expr->size = sizeof(LocalRef);
+                    return;
+                }
+                /* Capture array full: the depth walk still works. */
+            }
+
+            /* In-place rewrite; LocalRef and SymRef are the same size. */
+            LocalRef lr = { depth, slot, ref->name };
+            expr->type = NODE_LOCAL_REF;
+            memcpy(expr->car, &lr, sizeof(lr));
+            expr->size = sizeof(LocalRef);
+            return;
+        }
+
+        case NODE_LIST: {
+            ConsList* form = *(ConsList**)expr->car;
+            if (!form || !form->head) return;
+
+            Cons* head = form->head;
+            if (head->type == NODE_ATOM_SYM) {
+                if (sym_is(head, "quote")) return;
+
+                if (sym_is(head, "lambda")) {
+                    Cons* params_node = head->cdr;
+                    if (!params_node || params_node->type != NODE_LIST) return;
+                    ConsList* pl = *(ConsList**)params_node->car;
+                    CaptureRef caps[LOCALS_MAX_CAPS];
+                    LocalScope inner = {
+                        .up = scope,
+                        .params = pl ? pl->head : NULL,
+                        .slotted = !lambda_body_has_define(params_node->cdr),
+                        .nparams = pl ? (uint32_t)pl->length : 0,
+                        .caps = caps,
+                    };
+                    inner.capturing = inner.slotted;
+                    inner.mutated = mutated_params(params_node->cdr,
+                                                   inner.params);
+                    locals_chain(params_node->cdr, &inner, arena);
+
+                    /* Captures found: swap the parameter list for the
+                     * full signature. The payload stays pointer-sized,
+                     * so the cell is rewritten in place. */
+                    if (inner.cap_count) {
+                        LambdaSig* sig = (LambdaSig*)arena_alloc(arena,
+                            sizeof(LambdaSig) +
+                            inner.cap_count * sizeof(CaptureRef));
+                        if (!sig) return;
+                        sig->params = pl;
+                        sig->cap_count = inner.cap_count;
+                        memcpy(sig->caps, caps,
+                               inner.cap_count * sizeof(CaptureRef));
+                        params_node->type = NODE_LAMBDA_SIG;
+                        *(LambdaSig**)params_node->car = sig;
+                    }
+                    return;
+                }
+
+                if (sym_is(head, "define")) {
+                    Cons* target = head->cdr;
+                    if (!target) return;
+                    if (target->type == NODE_LIST) {
+                        /* (define (f a b) body...): f stays a symbol,
+                         * a and b become slots of the new frame. The
+                         * signature cell doubles as the binding target,
+                         * so this frame never turns into a LambdaSig. */
+                        const ConsList* sig = *(ConsList* const*)target->car;
+                        if (!sig || !sig->head) return;
+                        LocalScope inner = {
+                            .up = scope,
+                            .params = sig->head->cdr,
+                            .slotted = !lambda_body_has_define(target->cdr),
+                        };
+                        inner.mutated = mutated_params(target->cdr,
+                                                       inner.params);
+                        locals_chain(target->cdr, &inner, arena);
+                        return;
+                    }
+                    /* (define name value): only the value is code. */
+                    locals_chain(target->cdr, scope, arena);
+                    return;
+                }
+
+                /* set!'s target resolves like a read (the evaluator
+                 * writes the slot); if/begin heads stay keywords. */
+                if (sym_is(head, "if") || sym_is(head, "begin") ||
+                    sym_is(head, "set!")) {
+                    locals_chain(head->cdr, scope, arena);
+                    return;
+                }
+            }
+
+            locals_chain(head, scope, arena);
+            return;
+        }
+
+        default:
+            return;
+    }
+}
+
+void resolve_locals(ConsList* program, Arena** arena) {
+    if (!program || !arena || !*arena) return;
+    locals_chain(program->head, NULL, arena);
+}
+
+/* ------------------ Quasiquote expansion ------------------ */
+
+/*
+ * Quasiquoted templates used to reach the evaluator as opaque data, so
+ * the `,` holes were never filled and the constant parts would have to
+ * be walked as template every time. This pass expands them once, after
+ * parsing and before the other passes: a template with no holes
+ * collapses to a plain quote (one shared structure, vectorized later
+ * like any quoted data), and a template with holes becomes a (list ...)
+ * construction form where every constant segment is wrapped in a quote
+ * — shared across evaluations — and only the hole expressions are
+ * ordinary code. Running first means the synthesized heads go through
+ * builtin resolution and the hole expressions through local-slot
+ * resolution like hand-written code. Only depth-one unquotes are holes;
+ * a nested quasiquote stays data, as the evaluator always treated it.
+ */
+
+static bool qq_has_hole(const Cons* t) {
+    switch (t->type) {
+        case NODE_UNQUOTE:
+            return true;
+        case NODE_LIST: {
+            const ConsList* form = *(ConsList* const*)t->car;
+            for (const Cons* c = form ? form->head : NULL; c; c = c->cdr) {
+                if (qq_has_hole(c)) return true;
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+static Cons* qq_make_sym(const char* name, Arena** arena) {
+    SymRef ref;
+    if (intern_ref(&ref, name, strlen(name)) != 0) return NULL;
+    return make_atom(&ref, sizeof(ref), NODE_ATOM_SYM, arena);
+}
+
+/* Wrap a constant segment: the quote payload is a detached clone (the
+ * template chain links must not leak into evaluated values), but its
+ * interior structure — the expensive part — stays shared. */
+static Cons* qq_quote_const(const Cons* t, Arena** arena) {
+    Cons* payload = cons_clone_shallow(t, arena);
+    if (!payload) return NULL;
+    return make_atom(&payload, sizeof(Cons*), NODE_QUOTE, arena);
+}
+
+/* Returns a detached expression computing one template element. */
+static Cons* qq_expand(Cons* t, Arena** arena) {
+    if (t->type == NODE_UNQUOTE) {
+        /* The hole expression evaluates as ordinary code. */
+        return *(Cons**)t->car;
+    }
+
+    if (t->type == NODE_LIST && qq_has_hole(t)) {
+        ConsList* form = *(ConsList**)t->car;
+        ConsList* out = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+        if (!out) return NULL;
+        cons_list_init(out);
+
+        Cons* head = qq_make_sym("list", arena);
+        if (!head) return NULL;
+        cons_list_push_back(out, head);
+
+        /* qq_expand never returns the template cell itself, so pushing
+         * the result cannot disturb the chain being walked. */
+        for (Cons* c = form->head; c; c = c->cdr) {
+            Cons* e = qq_expand(c, arena);
+            if (!e) return NULL;
+            cons_list_push_back(out, e);
+        }
+        return wrap_list(out, arena);
+    }
+
+    return qq_quote_const(t, arena);
+}
+
+/*
+ * Rewrite one quasiquote cell in place. Both replacement payloads
+ * (quote: Cons*, construction form: ConsList*) are pointer-sized, the
+ * same as the template slot, so the cell and its chain stay put.
+ */
+static int qq_rewrite(Cons* expr, Arena** arena) {
+    Cons* template_ = *(Cons**)expr->car;
+    if (!template_) return 0;
+
+    if (!qq_has_hole(template_)) {
+        /* Pure constant: behaves exactly like quote from here on. */
+        expr->type = NODE_QUOTE;
+        return 0;
+    }
+
+    Cons* built = qq_expand(template_, arena);
+    if (!built) return -1;
+
+    if (built->type == NODE_LIST) {
+        expr->type = NODE_LIST;
+        *(ConsList**)expr->car = *(ConsList**)built->car;
+        return 0;
+    }
+
+    /* `,x at top level: the hole expression alone. Wrap it in (begin x)
+     * so the rewrite stays pointer-sized regardless of x's payload. */
+    ConsList* seq = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!seq) return -1;
+    cons_list_init(seq);
+    Cons* head = qq_make_sym("begin", arena);
+    if (!head) return -1;
+    cons_list_push_back(seq, head);
+    cons_list_push_back(seq, built);
+    expr->type = NODE_LIST;
+    *(ConsList**)expr->car = seq;
+    return 0;
+}
+
+/* Walk code structure looking for quasiquote boundaries. */
+static int qq_walk_expr(Cons* expr, Arena** arena) {
+    switch (expr->type) {
+        case NODE_QUASIQUOTE:
+            return qq_rewrite(expr, arena);
+
+        case NODE_LIST: {
+            ConsList* form = *(ConsList**)expr->car;
+            if (!form || !form->head) return 0;
+            if (sym_is(form->head, "quote")) return 0;
+
+            for (Cons* c = form->head; c; c = c->cdr) {
+                if (qq_walk_expr(c, arena) != 0) return -1;
+            }
+            return 0;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+int expand_quasiquote(ConsList* program, Arena** arena) {
+    if (!program || !arena || !*arena) return -1;
+    for (Cons* c = program->head; c; c = c->cdr) {
+        if (qq_walk_expr(c, arena) != 0) return -1;
+    }
+    return 0;
+}
+
+/* ------------------ Constant folding ------------------ */
+
+/*
+ * Generated configs carry large amounts of layout math whose inputs are
+ * all literals — (+ base-x (* col 64)) with both operands known at parse
+ * time. This pass evaluates such forms once instead of on every run:
+ * call forms whose head resolved to a pure builtin (the numeric and
+ * comparison kernels, plus car/cdr/list over quoted data) and whose
+ * arguments are literals collapse into their result, and an if with a
+ * literal condition drops its dead branch. Folding calls the very
+ * dispatch-table entry the evaluator would, so numeric promotion, the
+ * shared small-int pool and the truth convention match runtime exactly;
+ * a form is only folded when the pre-checks guarantee the builtin
+ * succeeds, so errors keep being reported at evaluation, where a form
+ * that never runs never reports. Runs after builtin resolution (heads
+ * are already BuiltinType bytes) and before local resolution and
+ * vectorization, which see the folded atoms like hand-written ones.
+ */
+
+static bool fold_is_num(const Cons* c) {
+    return c->type == NODE_ATOM_INT || c->type == NODE_ATOM_FLOAT;
+}
+
+static bool fold_is_zero(const Cons* c) {
+    if (c->type == NODE_ATOM_INT) return *(const long long*)c->car == 0;
+    return *(const long double*)c->car == 0.0L;
+}
+
+/*
+ * True when dispatching t on these (unevaluated, literal) arguments is
+ * guaranteed to succeed: arity, operand types and division by zero are
+ * exactly the failure modes of the pure builtins.
+ */
+static bool fold_args_ok(BuiltinType t, const Cons* args) {
+    size_t n = 0;
+    for (const Cons* c = args; c; c = c->cdr) n++;
+
+    switch (t) {
+        case BUILTIN_ADD:
+        case BUILTIN_MUL:
+        case BUILTIN_SUB:
+        case BUILTIN_DIV:
+            if ((t == BUILTIN_SUB || t == BUILTIN_DIV) && n < 1) return false;
+            for (const Cons* c = args; c; c = c->cdr) {
+                if (!fold_is_num(c)) return false;
+                if (t == BUILTIN_DIV && c != args && fold_is_zero(c)) {
+                    return false;
+                }
+            }
+            return true;
+
+        case BUILTIN_MOD:
+            return n == 2 && args->type == NODE_ATOM_INT &&
+                   args->cdr->type == NODE_ATOM_INT &&
+                   !fold_is_zero(args->cdr);
+
+        case BUILTIN_NUM_EQ:
+        case BUILTIN_LESS_THAN:
+        case BUILTIN_GREATER_THAN:
+        case BUILTIN_LESS_EQ:
+        case BUILTIN_GREATER_EQ:
+            if (n < 2) return false;
+            for (const Cons* c = args; c; c = c->cdr) {
+                if (!fold_is_num(c)) return false;
+            }
+            return true;
+
+        case BUILTIN_CAR:
+        case BUILTIN_CDR:
+            /* Quoted payloads are still cdr-chained here (vectorization
+             * runs later), so NODE_LIST is the only list shape. */
+            return n == 1 && args->type == NODE_QUOTE &&
+                   (*(Cons* const*)args->car)->type == NODE_LIST;
+
+        case BUILTIN_LIST:
+            for (const Cons* c = args; c; c = c->cdr) {
+                if (!fold_is_num(c) && c->type != NODE_QUOTE) return false;
+            }
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/* The runtime value of a literal argument, detached so builtins may
+ * chain it (builtin_list captures its argument cells directly). */
+static Cons* fold_arg_value(const Cons* c, Arena** arena) {
+    if (c->type == NODE_QUOTE) {
+        return cons_clone_shallow(*(Cons* const*)c->car, arena);
+    }
+    return cons_clone_shallow(c, arena);
+}
+
+/*
+ * Splice a computed value over the call cell. Integers and nil fit the
+ * pointer-sized payload and are copied in place; everything else
+ * (16-byte long double floats, list results) hides behind a quote,
+ * which the evaluator unwraps with a single load. A NODE_LIST result
+ * must take the quote path regardless: spliced in place it would read
+ * as a call form again.
+ */
+static int fold_replace_value(Cons* expr, Cons* result, Arena** arena) {
+    if (result->size <= sizeof(void*) && result->type != NODE_LIST) {
+        expr->type = result->type;
+        expr->size = result->size;
+        memcpy(expr->car, result->car, result->size);
+        return 0;
+    }
+
+    Cons* payload = cons_clone_shallow(result, arena);
+    if (!payload) return -1;
+    expr->type = NODE_QUOTE;
+    *(Cons**)expr->car = payload;
+    expr->size = sizeof(Cons*);
+    return 0;
+}
+
+static int fold_try_builtin(Cons* expr, const ConsList* form, Arena** arena) {
+    BuiltinType t = *(const BuiltinType*)form->head->car;
+    if (!fold_args_ok(t, form->head->cdr)) return 0;
+
+    ConsList* args = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!args) return -1;
+    cons_list_init(args);
+    for (const Cons* c = form->head->cdr; c; c = c->cdr) {
+        Cons* v = fold_arg_value(c, arena);
+        if (!v) return -1;
+        cons_list_push_back(args, v);
+    }
+
+    Cons* result = builtin_dispatch_table[t](args, arena);
+    if (!result) return 0;     /* pre-checks missed a case: fold nothing */
+    return fold_replace_value(expr, result, arena);
+}
+
+/* Literal conditions decide at parse time; non-literals return false. */
+static bool fold_literal_truth(const Cons* c, bool* truth) {
+    switch (c->type) {
+        case NODE_ATOM_INT:
+        case NODE_ATOM_FLOAT:
+            *truth = true;
+            return true;
+        case NODE_QUOTE: {
+            const Cons* payload = *(Cons* const*)c->car;
+            *truth = payload && payload->type != NODE_NIL;
+            return true;
+        }
+        case NODE_NIL:      /* a folded comparison that came out false */
+            *truth = false;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Splice the surviving branch over the if cell. Pointer-sized payloads
+ * (calls, quotes, integers) are copied in place; larger ones (a 16-byte
+ * SymRef, a float) keep the cell's shape behind a (begin branch)
+ * wrapper, the same trick qq_rewrite uses.
+ */
+static int fold_splice_code(Cons* expr, const Cons* branch, Arena** arena) {
+    if (branch->size <= sizeof(void*)) {
+        expr->type = branch->type;
+        expr->size = branch->size;
+        memcpy(expr->car, branch->car, branch->size);
+        return 0;
+    }
+
+    ConsList* seq = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!seq) return -1;
+    cons_list_init(seq);
+    Cons* head = qq_make_sym("begin", arena);
+    if (!head) return -1;
+    cons_list_push_back(seq, head);
+    Cons* body = cons_clone_shallow(branch, arena);
+    if (!body) return -1;
+    cons_list_push_back(seq, body);
+    expr->type = NODE_LIST;
+    *(ConsList**)expr->car = seq;
+    expr->size = sizeof(ConsList*);
+    return 0;
+}
+
+static int fold_if(Cons* expr, Cons* cond, Arena** arena) {
+    if (!cond || !cond->cdr) return 0;  /* malformed: the evaluator reports */
+
+    bool truth;
+    if (!fold_literal_truth(cond, &truth)) return 0;
+
+    const Cons* branch = truth ? cond->cdr : cond->cdr->cdr;
+    if (!branch) {
+        /* (if <false> then) with no alternative evaluates to nil. */
+        expr->type = NODE_NIL;
+        expr->size = 0;
+        return 0;
+    }
+    return fold_splice_code(expr, branch, arena);
+}
+
+static int fold_expr(Cons* expr, Arena** arena);
+
+static int fold_chain(Cons* head, Arena** arena) {
+    for (Cons* c = head; c; c = c->cdr) {
+        if (fold_expr(c, arena) != 0) return -1;
+    }
+    return 0;
+}
+
+static int fold_expr(Cons* expr, Arena** arena) {
+    if (expr->type != NODE_LIST) return 0;
+
+    ConsList* form = *(ConsList**)expr->car;
+    if (!form || !form->head) return 0;
+    Cons* head = form->head;
+
+    if (head->type == NODE_ATOM_SYM) {
+        if (sym_is(head, "quote")) return 0;
+
+        /* Syntax slots stay literal; only the body chains are code. */
+        if (sym_is(head, "define") || sym_is(head, "lambda")) {
+            return head->cdr ? fold_chain(head->cdr->cdr, arena) : 0;
+        }
+
+        if (sym_is(head, "if")) {
+            if (fold_chain(head->cdr, arena) != 0) return -1;
+            return fold_if(expr, head->cdr, arena);
+        }
+
+        /* begin, set!, user calls: every operand is ordinary code. */
+        return fold_chain(head->cdr, arena);
+    }
+
+    if (head->type == NODE_BUILTIN) {
+        /* Bottom-up: operands fold first so nested literal math
+         * cascades into a single atom. */
+        if (fold_chain(head->cdr, arena) != 0) return -1;
+        return fold_try_builtin(expr, form, arena);
+    }
+
+    /* Computed operator, e.g. ((lambda (x) x) 1). */
+    return fold_chain(head, arena);
+}
+
+int fold_constants(ConsList* program, Arena** arena) {
+    if (!program || !arena || !*arena) return -1;
+    for (Cons* c = program->head; c; c = c->cdr) {
+        if (fold_expr(c, arena) != 0) return -1;
+    }
+    return 0;
+}
+
+/*
+ * Quoted lists are pure data that gets iterated, never restructured, so
+ * they can trade the cdr chain for a contiguous Cons* array: a linear
+ * scan the prefetcher can follow, O(1) element access, and an O(1) cdr
+ * view (items+1) without allocating a ConsList.
+ */
+static Cons* vectorize_data(Cons* expr, Arena** arena);
+
+/* Rewrite a Cons* slot (quote payload, sibling link) if needed. */
+static int vectorize_slot(Cons** slot, Arena** arena) {
+    if (!*slot) return 0;
+    Cons* repl = vectorize_data(*slot, arena);
+    if (!repl) return -1;
+    if (repl != *slot) {
+        repl->cdr = (*slot)->cdr;
+        *slot = repl;
+    }
+    return 0;
+}
+
+/*
+ * Returns the node to use in place of expr: either expr itself (atoms,
+ * already-converted children updated in place) or a fresh
+ * NODE_VECTOR_LIST cons (the VecList payload does not fit in a
+ * NODE_LIST cell, so lists cannot be rewritten in place).
+ */
+static Cons* vectorize_data(Cons* expr, Arena** arena) {
+    switch (expr->type) {
+        case NODE_LIST: {
+            ConsList* form = *(ConsList**)expr->car;
+            size_t count = form ? form->length : 0;
+
+            Cons** items = NULL;
+            if (count) {
+                items = (Cons**)arena_alloc(arena, count * sizeof(Cons*));
+                if (!items) return NULL;
+                size_t i = 0;
+                for (Cons* c = form->head; c; c = c->cdr) {
+                    Cons* child = vectorize_data(c, arena);
+                    if (!child) return NULL;
+                    items[i++] = child;
+                }
+            }
+            return make_vector_list(items, count, arena);
+        }
+
+        case NODE_QUOTE:
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE:
+            if (vectorize_slot((Cons**)expr->car, arena) != 0) return NULL;
+            return expr;
+
+        default:
+            return expr;
+    }
+}
+
+/* Walk code structure looking for quote boundaries. */
+static int vectorize_expr(Cons* expr, Arena** arena) {
+    switch (expr->type) {
+        case NODE_QUOTE:
+            return vectorize_slot((Cons**)expr->car, arena);
+
+        case NODE_LIST: {
+            ConsList* form = *(ConsList**)expr->car;
+            if (!form || !form->head) return 0;
+
+            /* (quote x): convert x, keep the form itself structural. */
+            if (sym_is(form->head, "quote")) {
+                if (form->head->cdr) {
+                    Cons* prev = form->head;
+                    if (vectorize_slot(&prev->cdr, arena) != 0) return -1;
+                    if (form->length == 2) form->tail = prev->cdr;
+                }
+                return 0;
+            }
+
+            for (Cons* c = form->head; c; c = c->cdr) {
+                if (vectorize_expr(c, arena) != 0) return -1;
+            }
+            return 0;
+        }
+
+        default:
+            return 0;
+    }
+}
+
+int vectorize_quoted(ConsList* program, Arena** arena) {
+    if (!program || !arena || !*arena) return -1;
+    for (Cons* c = program->head; c; c = c->cdr) {
+        if (vectorize_expr(c, arena) != 0) return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file passes.h
+ * @brief AST passes run between parsing and evaluation.
+ *
+ * Builtin resolution rewrites NODE_ATOM_SYM heads of call forms into
+ * NODE_BUILTIN cells carrying the BuiltinType directly, so the eval hot
+ * loop dispatches with one array index instead of a gperf hash + memcmp
+ * per call. The rewrite happens in place (the payload shrinks from a
+ * SymRef to one byte) and never descends into quoted data, special-form
+ * syntax (define signatures, lambda parameter lists), or quasiquote
+ * templates.
+ *
+ * Builtin names become statically bound by this pass: a later define of
+ * '+' no longer shadows already-resolved call sites.
+ */
+#ifndef PASSES_H
+#define PASSES_H
+
+#include "parser.h"
+
+/**
+ * @brief Expand quasiquote templates once, at parse time.
+ *
+ * Templates without unquote holes collapse into plain quotes; templates
+ * with holes become (list ...) construction forms whose constant
+ * segments are quoted — shared across evaluations — and whose holes are
+ * ordinary code. Runs before the other passes so the synthesized forms
+ * go through builtin and local resolution like hand-written code.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int expand_quasiquote(ConsList* program, Arena** arena);
+
+/**
+ * @brief Resolve builtin call heads across a whole program, in place.
+ */
+void resolve_builtins(ConsList* program);
+
+/**
+ * @brief Fold pure builtin applications of literals into their result
+ *        and drop the dead branch of literal-condition ifs, in place.
+ *
+ * Results come from the same dispatch-table entries the evaluator uses,
+ * and a form is folded only when its pre-checks guarantee success, so
+ * errors stay runtime errors. Runs after resolve_builtins (call heads
+ * must already be NODE_BUILTIN) and before the later passes.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int fold_constants(ConsList* program, Arena** arena);
+
+/**
+ * @brief Number lambda parameters to (depth, slot) pairs, in place.
+ *
+ * References to parameters of lambdas without internal defines become
+ * NODE_LOCAL_REF nodes read straight out of flat activation records
+ * (@see ActRec); everything else keeps the Symtab path. Outer-parameter
+ * reads inside such lambdas are additionally flattened into a capture
+ * plan (@see LambdaSig): the closure copies those values next to its
+ * own parameters at creation time and the references become depth-0
+ * slots, except for parameters the owning body ever set!s, which keep
+ * the shared-slot depth walk. @p arena backs the LambdaSig blocks.
+ */
+void resolve_locals(ConsList* program, Arena** arena);
+
+/**
+ * @brief True when a body chain contains a define outside nested
+ *        lambdas and quoted data. Shared with the evaluator, which must
+ *        agree with the pass on which calls need a full Symtab.
+ */
+bool lambda_body_has_define(const Cons* body);
+
+/**
+ * @brief Convert quoted data lists to the contiguous NODE_VECTOR_LIST
+ *        layout (@see VecList). Code structure is left untouched.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int vectorize_quoted(ConsList* program, Arena** arena);
+
+#endif
@@ -11,6 +11,7 @@
 typedef struct {
     char *data;
     size_t size;
+    size_t map_len;     ///< Mapped length (>= size; huge mappings round up)
     bool is_mmaped;
 } FileBuffer;
 
@@ -41,5 +42,14 @@ FileBuffer *read_file(const char *path);
  */
 void filebuffer_free(FileBuffer * fb);
 
+/**
+ * @brief Hint that the raw source bytes are no longer needed.
+ *
+ * Call after parsing: strings and symbols were copied out, so the
+ * kernel can drop the pages (MADV_DONTNEED) while the buffer pointer
+ * stays valid. No-op for malloc'd buffers.
+ */
+void filebuffer_discard(FileBuffer * fb);
+
 
 #endif
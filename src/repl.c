@@ -0,0 +1,127 @@
+/*
+ * @file repl.c
+ */
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "repl.h"
+#include "arena.h"
+#include "parser.h"
+#include "passes.h"
+#include "eval.h"
+#include "symtab.h"
+
+#define REPL_INPUT_MAX (64 * 1024)
+
+/*
+ * Paren balance outside string literals and ;-comments — the same
+ * boundary rules the lexer applies — so multi-line forms accumulate
+ * until they are complete.
+ */
+typedef struct BalanceState {
+    int depth;
+    bool in_string;
+    bool escaped;
+    bool saw_form;      ///< Any non-whitespace input yet
+} BalanceState;
+
+static void balance_feed(BalanceState* b, const char* line, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        char c = line[i];
+        if (b->in_string) {
+            if (b->escaped)       b->escaped = false;
+            else if (c == '\\')   b->escaped = true;
+            else if (c == '"')    b->in_string = false;
+            continue;
+        }
+        if (c == ';') break;    /* comment runs to end of line */
+        if (c == '"')       { b->in_string = true; b->saw_form = true; }
+        else if (c == '(')  { b->depth++; b->saw_form = true; }
+        else if (c == ')')  { b->depth--; }
+        else if (!isspace((unsigned char)c)) { b->saw_form = true; }
+    }
+}
+
+int repl_run(FILE* in, FILE* out) {
+    Arena* global_head = arena_create(2 * 1024 * 1024);
+    if (!global_head) {
+        fprintf(stderr, "Failed to create session memory arena.\n");
+        return -1;
+    }
+    Arena* global_arena = global_head;
+
+    Arena* scratch_head = arena_create(1024 * 1024);
+    Symtab* globals = symtab_new(NULL, &global_arena);
+    if (!scratch_head || !globals) {
+        fprintf(stderr, "Failed to set up session state.\n");
+        arena_free(scratch_head);
+        arena_free(global_head);
+        return -1;
+    }
+    Arena* scratch_arena = scratch_head;
+
+    bool interactive = isatty(fileno(in));
+
+    static char input[REPL_INPUT_MAX];
+    static char line[4096];
+    size_t len = 0;
+    BalanceState bal = { 0 };
+
+    for (;;) {
+        if (interactive) {
+            fputs(len ? "  ... " : "wisp> ", out);
+            fflush(out);
+        }
+        if (!fgets(line, sizeof(line), in)) break;
+
+        size_t n = strlen(line);
+        if (len + n >= sizeof(input)) {
+            fprintf(stderr, "Eval Error: input exceeds %d bytes; discarded.\n",
+                    REPL_INPUT_MAX);
+            len = 0;
+            bal = (BalanceState){ 0 };
+            continue;
+        }
+        memcpy(input + len, line, n);
+        len += n;
+
+        balance_feed(&bal, line, n);
+        if (bal.depth > 0 || bal.in_string || !bal.saw_form) continue;
+        if (bal.depth < 0) {
+            fprintf(stderr, "Eval Error: unbalanced ')'.\n");
+            len = 0;
+            bal = (BalanceState){ 0 };
+            continue;
+        }
+
+        /* One complete input: the full file pipeline on just this form.
+         * The AST lands in the session arena (closures may keep it). */
+        ConsList* forms = parse_stream(input, len, &global_arena);
+        len = 0;
+        bal = (BalanceState){ 0 };
+        if (!forms || !forms->head) {
+            if (!forms) fprintf(stderr, "Parsing failed.\n");
+            continue;
+        }
+
+        expand_quasiquote(forms, &global_arena);
+        resolve_builtins(forms);
+        fold_constants(forms, &global_arena);
+        resolve_locals(forms, &global_arena);
+        vectorize_quoted(forms, &global_arena);
+
+        /* eval_program promotes the result into the session arena, so
+         * printing after the scratch reset is safe. */
+        Cons* result = eval_program(forms, globals, &scratch_arena);
+        if (result) {
+            print_expression(out, result);
+        }
+    }
+
+    if (interactive) fputc('\n', out);
+    arena_free(scratch_head);
+    arena_free(global_head);
+    return 0;
+}
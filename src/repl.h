@@ -0,0 +1,30 @@
+/**
+ * @file repl.h
+ * @brief Interactive read-eval-print loop with persistent session state.
+ *
+ * One-shot file execution pays the whole cold start — arena creation,
+ * interning, global Symtab setup — per run. The REPL keeps all of that
+ * alive across inputs: each entered form is lexed and parsed alone, run
+ * through the same pass pipeline as a file, and evaluated against the
+ * live global environment, so warm evaluation of a small form costs
+ * only the form itself.
+ */
+#ifndef REPL_H
+#define REPL_H
+
+#include <stdio.h>
+
+/**
+ * @brief Run the interactive loop until EOF on @p in.
+ *
+ * Forms may span lines: input is accumulated until the parentheses
+ * balance (string literals and ;-comments excluded, per the lexer's
+ * rules). Each complete input is evaluated as a mini program and its
+ * result printed to @p out. Prompts are only shown when @p in is a
+ * terminal, so piping forms through stdin stays clean.
+ *
+ * @return 0 on clean EOF, -1 if the session could not be set up.
+ */
+int repl_run(FILE* in, FILE* out);
+
+#endif /* REPL_H */
@@ -0,0 +1,120 @@
+/*
+ * @file stats.c
+ */
+#include "stats.h"
+
+#ifdef WISP_INSTRUMENT
+
+#include <assert.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "builtins.h"
+
+static_assert(BUILTIN_COUNT <= WISP_STATS_MAX_BUILTINS,
+              "grow WISP_STATS_MAX_BUILTINS");
+
+WispStats wisp_stats;
+
+static const char* const stage_names[WISP_STAGE_COUNT] = {
+    [WISP_STAGE_LEX]    = "lex",
+    [WISP_STAGE_PARSE]  = "parse",
+    [WISP_STAGE_PASSES] = "passes",
+    [WISP_STAGE_EVAL]   = "eval",
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void wisp_stage_begin(WispStage stage) {
+    wisp_stats.stage_t0[stage] = now_ns();
+}
+
+void wisp_stage_end(WispStage stage) {
+    wisp_stats.stage_ns[stage] += now_ns() - wisp_stats.stage_t0[stage];
+}
+
+/*
+ * The whole report is rendered into one stack buffer and pushed out with
+ * a single write(2): no stdio locks, no allocation, so the SIGUSR1 path
+ * can share this code. snprintf is not on the async-signal-safe list,
+ * but it touches no global state here; for a diagnostics build that
+ * trade is fine.
+ */
+void wisp_stats_dump(int fd) {
+    char buf[4096];
+    size_t off = 0;
+
+#define PUT(...) \
+    do { \
+        int n_ = snprintf(buf + off, sizeof(buf) - off, __VA_ARGS__); \
+        if (n_ > 0 && (size_t)n_ < sizeof(buf) - off) off += (size_t)n_; \
+    } while (0)
+
+    PUT("=== Wisp instrumentation ===\n");
+
+    PUT("stages:");
+    for (int s = 0; s < WISP_STAGE_COUNT; s++) {
+        PUT(" %s=%.3fms", stage_names[s],
+            (double)wisp_stats.stage_ns[s] / 1e6);
+    }
+    PUT("\n");
+
+    uint64_t calls = wisp_stats.alloc_calls;
+    PUT("arena: %llu alloc(s), %llu bytes, %llu link(s) mapped\n",
+        (unsigned long long)calls,
+        (unsigned long long)wisp_stats.alloc_bytes,
+        (unsigned long long)wisp_stats.arena_links);
+
+    uint64_t probes = wisp_stats.probe_count;
+    PUT("symtab: %llu probe(s), avg length %.2f, max %llu\n",
+        (unsigned long long)probes,
+        probes ? (double)wisp_stats.probe_total / (double)probes : 0.0,
+        (unsigned long long)wisp_stats.probe_max);
+
+    PUT("builtins:");
+    for (int b = 0; b < BUILTIN_COUNT; b++) {
+        uint64_t n = wisp_stats.builtin_calls[b];
+        if (!n) continue;
+        PUT(" %s=%llu", builtin_type_names[b], (unsigned long long)n);
+    }
+    PUT("\n");
+
+#undef PUT
+
+    ssize_t ignored = write(fd, buf, off);
+    (void)ignored;
+}
+
+static void dump_at_exit(void) {
+    wisp_stats_dump(STDERR_FILENO);
+}
+
+static void dump_on_signal(int sig) {
+    (void)sig;
+    wisp_stats_dump(STDERR_FILENO);
+}
+
+void wisp_stats_install(void) {
+    atexit(dump_at_exit);
+
+    struct sigaction sa = { 0 };
+    sa.sa_handler = dump_on_signal;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, NULL);
+}
+
+#else /* !WISP_INSTRUMENT */
+
+/* Keep the translation unit non-empty for -Wpedantic builds. */
+typedef int wisp_stats_unused;
+
+#endif /* WISP_INSTRUMENT */
@@ -0,0 +1,107 @@
+/**
+ * @file stats.h
+ * @brief Compile-time-gated self-instrumentation.
+ *
+ * Built with -Dinstrument=true (meson) the interpreter accounts for
+ * itself: per-builtin dispatch counts, wall time per pipeline stage,
+ * arena_alloc traffic and chain growth, and symtab probe lengths. The
+ * report goes to stderr at exit, or on SIGUSR1 without stopping — for
+ * hosts where attaching an external profiler is awkward.
+ *
+ * With the option off every hook expands to ((void)0) and stats.c is an
+ * empty translation unit: production builds pay nothing.
+ */
+#ifndef STATS_H
+#define STATS_H
+
+#ifdef WISP_INSTRUMENT
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+/// Sized independently of BuiltinType so low-level units (arena.c,
+/// symtab.c) can include this header without pulling in eval.h; checked
+/// against BUILTIN_COUNT in stats.c.
+#define WISP_STATS_MAX_BUILTINS 64
+
+typedef enum WispStage {
+    WISP_STAGE_LEX,
+    WISP_STAGE_PARSE,
+    WISP_STAGE_PASSES,
+    WISP_STAGE_EVAL,
+
+    WISP_STAGE_COUNT
+} WispStage;
+
+/*
+ * Counters are atomics because pmap workers (@see builtin_pmap) dispatch
+ * builtins and allocate concurrently; increments use relaxed ordering —
+ * totals matter, interleavings do not.
+ */
+typedef struct WispStats {
+    _Atomic uint64_t builtin_calls[WISP_STATS_MAX_BUILTINS];
+    _Atomic uint64_t alloc_calls;
+    _Atomic uint64_t alloc_bytes;
+    _Atomic uint64_t arena_links;
+    _Atomic uint64_t probe_count;
+    _Atomic uint64_t probe_total;
+    _Atomic uint64_t probe_max;
+    uint64_t stage_ns[WISP_STAGE_COUNT];    ///< Main thread only
+    uint64_t stage_t0[WISP_STAGE_COUNT];
+} WispStats;
+
+extern WispStats wisp_stats;
+
+void wisp_stage_begin(WispStage stage);
+void wisp_stage_end(WispStage stage);
+
+/**
+ * @brief Register the exit dump and the SIGUSR1 mid-run dump.
+ */
+void wisp_stats_install(void);
+
+/**
+ * @brief Format the report into a local buffer and write(2) it to @p fd
+ *        (one syscall; safe to call from the signal handler).
+ */
+void wisp_stats_dump(int fd);
+
+static inline void wisp_stat_count(_Atomic uint64_t* c, uint64_t n) {
+    atomic_fetch_add_explicit(c, n, memory_order_relaxed);
+}
+
+static inline void wisp_stat_probe(uint64_t len) {
+    wisp_stat_count(&wisp_stats.probe_count, 1);
+    wisp_stat_count(&wisp_stats.probe_total, len);
+    uint64_t m = atomic_load_explicit(&wisp_stats.probe_max,
+                                      memory_order_relaxed);
+    while (len > m &&
+           !atomic_compare_exchange_weak_explicit(&wisp_stats.probe_max,
+                                                  &m, len,
+                                                  memory_order_relaxed,
+                                                  memory_order_relaxed)) {
+    }
+}
+
+#define WISP_STAT_BUILTIN(t)    wisp_stat_count(&wisp_stats.builtin_calls[(t)], 1)
+#define WISP_STAT_ALLOC(n)      (wisp_stat_count(&wisp_stats.alloc_calls, 1), \
+                                 wisp_stat_count(&wisp_stats.alloc_bytes, (n)))
+#define WISP_STAT_ARENA_LINK()  wisp_stat_count(&wisp_stats.arena_links, 1)
+#define WISP_STAT_PROBE(len)    wisp_stat_probe(len)
+#define WISP_STAGE_BEGIN(s)     wisp_stage_begin(s)
+#define WISP_STAGE_END(s)       wisp_stage_end(s)
+#define WISP_STATS_INSTALL()    wisp_stats_install()
+
+#else /* !WISP_INSTRUMENT */
+
+#define WISP_STAT_BUILTIN(t)    ((void)0)
+#define WISP_STAT_ALLOC(n)      ((void)0)
+#define WISP_STAT_ARENA_LINK()  ((void)0)
+#define WISP_STAT_PROBE(len)    ((void)0)
+#define WISP_STAGE_BEGIN(s)     ((void)0)
+#define WISP_STAGE_END(s)       ((void)0)
+#define WISP_STATS_INSTALL()    ((void)0)
+
+#endif /* WISP_INSTRUMENT */
+
+#endif /* STATS_H */
@@ -2,10 +2,13 @@
  * @file symtab.c
  */
 #include "symtab.h"
+#include "stats.h"
 #include <stdint.h>
 #include <string.h>
 
 
+_Atomic uint64_t symtab_generation = 1;
+
 uint32_t symtab_hash(const char* str) {
     uint32_t hash = 2166136261u;
     while (*str) {
@@ -15,96 +18,159 @@ uint32_t symtab_hash(const char* str) {
     return hash;
 }
 
+/* Probe distance of the entry sitting at idx (Robin Hood invariant). */
+static inline size_t probe_distance(uint32_t hash, size_t idx, size_t mask) {
+    return (idx - (size_t)(hash & mask)) & mask;
+}
+
+/* The table is touched only after both allocations succeed, so a failed
+ * grow leaves the caller's records fully intact. */
+static int symtab_alloc_slots(Symtab* st, size_t size) {
+    Symbol* slots = (Symbol*)arena_alloc(st->arena, sizeof(Symbol) * size);
+    uint32_t* hashes = (uint32_t*)arena_alloc(st->arena, sizeof(uint32_t) * size);
+    if (!slots || !hashes) return -1;
+
+    memset(slots, 0, sizeof(Symbol) * size);
+    memset(hashes, 0, sizeof(uint32_t) * size);
+    st->slots = slots;
+    st->hashes = hashes;
+    st->size = size;
+    return 0;
+}
+
 Symtab* symtab_new(Symtab* parent, Arena** arena) {
     if (!arena || !*arena) return NULL;
 
     Symtab* st = (Symtab*)arena_alloc(arena, sizeof(Symtab));
     if (!st) return NULL;
 
-    size_t initial_size = parent ? 16 : SYMTAB_INITIAL_SIZE;
-
-    st->slots = (Symbol**)arena_alloc(arena, sizeof(Symbol*) * initial_size);
-    if (!st->slots) return NULL;
-
-    memset(st->slots, 0, sizeof(Symbol*) * initial_size);
-
-    st->size = initial_size;
-    st->count = 0;
     st->arena = arena;
+    st->count = 0;
     st->parent = parent;
 
+    size_t initial_size = parent ? SYMTAB_CHILD_SIZE : SYMTAB_INITIAL_SIZE;
+    if (symtab_alloc_slots(st, initial_size) != 0) return NULL;
+
     return st;
 }
 
-static void symtab_grow(Symtab* st) {
-    if (st->count < (size_t)(st->size * SYMTAB_LOAD_FACTOR)) return;
-
-    size_t new_size = st->size * 2;
+/*
+ * Insert a fully-initialized record, displacing richer entries as we go
+ * (Robin Hood): whenever the record in hand has probed further than the
+ * resident one, they swap and the resident continues. Keeps worst-case
+ * probe lengths tight so lookups scan short contiguous runs.
+ */
+static Symbol* slots_insert(Symtab* st, Symbol rec) {
+    size_t mask = st->size - 1;
+    size_t idx = rec.hash & mask;
+    size_t dist = 0;
+    Symbol* placed = NULL;
+
+    for (;;) {
+        if (st->slots[idx].name == NULL) {
+            st->slots[idx] = rec;
+            st->hashes[idx] = rec.hash;
+            return placed ? placed : &st->slots[idx];
+        }
 
-    Symbol** new_slots = arena_alloc(st->arena, sizeof(Symbol*) * new_size);
-    if (!new_slots) return;
+        size_t resident_dist = probe_distance(st->hashes[idx], idx, mask);
+        if (resident_dist < dist) {
+            Symbol tmp = st->slots[idx];
+            uint32_t tmp_hash = st->hashes[idx];
+            st->slots[idx] = rec;
+            st->hashes[idx] = rec.hash;
+            if (!placed) placed = &st->slots[idx];
+            rec = tmp;
+            rec.hash = tmp_hash;
+            dist = resident_dist;
+        }
 
-    memset(new_slots, 0, sizeof(Symbol*) * new_size);
+        idx = (idx + 1) & mask;
+        dist++;
+    }
+}
 
-    for (size_t i = 0; i < st->size; i++) {
-        Symbol* chain = st->slots[i];
-        while (chain) {
-            Symbol* next = chain->next;
+static void symtab_grow(Symtab* st) {
+    if (st->count < (size_t)(st->size * SYMTAB_LOAD_FACTOR)) return;
 
+    Symbol* old_slots = st->slots;
+    size_t old_size = st->size;
 
-            size_t new_idx = chain->hash % new_size;
-            chain->next = new_slots[new_idx];
-            new_slots[new_idx] = chain;
+    if (symtab_alloc_slots(st, old_size * 2) != 0) return;
 
-            chain = next;
-        }
+    for (size_t i = 0; i < old_size; i++) {
+        if (old_slots[i].name == NULL) continue;
+        slots_insert(st, old_slots[i]);
     }
 
+    /* Every record just moved: cached Symbol* are stale. */
+    symtab_generation++;
+}
 
-    st->slots = new_slots;
-    st->size = new_size;
+/*
+ * Shared probe loop: returns the matching record or NULL. The Robin Hood
+ * invariant allows an early miss exit as soon as we pass a record that
+ * probed less far than we have.
+ */
+static Symbol* slots_find(const Symtab* st, uint32_t hash, const char* name) {
+    size_t mask = st->size - 1;
+    size_t idx = hash & mask;
+    size_t dist = 0;
+
+    for (;;) {
+        if (st->slots[idx].name == NULL) {
+            WISP_STAT_PROBE(dist + 1);
+            return NULL;
+        }
+        if (st->hashes[idx] == hash) {
+            Symbol* sym = &st->slots[idx];
+            if (sym->name == name || strcmp(name, sym->name) == 0) {
+                WISP_STAT_PROBE(dist + 1);
+                return sym;
+            }
+        }
+        if (probe_distance(st->hashes[idx], idx, mask) < dist) {
+            WISP_STAT_PROBE(dist + 1);
+            return NULL;
+        }
+        idx = (idx + 1) & mask;
+        dist++;
+    }
 }
 
 Symbol* symtab_define(Symtab* st, const char* name, Cons* value, bool is_const) {
     if (!st || !name) return NULL;
 
     uint32_t hash = symtab_hash(name);
-    size_t idx = hash % st->size;
-
-    Symbol* current = st->slots[idx];
-    while (current) {
-        if (current->hash == hash &&
-            strcmp(name, current->name) == 0){
-            if (current->is_const) {
-                return NULL;
-            }
-            current->value = value;
-            current->is_const = is_const;
-            return current;
+
+    Symbol* existing = slots_find(st, hash, name);
+    if (existing) {
+        if (existing->is_const) {
+            return NULL;
         }
-        current = current->next;
+        existing->value = value;
+        existing->is_const = is_const;
+        return existing;
     }
 
-
-    Symbol* sym = arena_alloc(st->arena, sizeof(Symbol));
-    if (!sym) return NULL;
-
     size_t name_len = strlen(name) + 1;
     char* interned_name = arena_alloc(st->arena, name_len);
     if (!interned_name) return NULL;
     memcpy(interned_name, name, name_len);
 
-    sym->name = interned_name;
-    sym->value = value;
-    sym->hash = hash;
-    sym->is_const = is_const;
-
-
-    sym->next = st->slots[idx];
-    st->slots[idx] = sym;
+    Symbol rec = {
+        .name = interned_name,
+        .value = value,
+        .hash = hash,
+        .is_const = is_const,
+    };
 
+    Symbol* sym = slots_insert(st, rec);
     st->count++;
 
+    /* A new binding may shadow what cached sites resolved to. */
+    symtab_generation++;
+
     symtab_grow(st);
 
     return sym;
@@ -115,37 +181,62 @@ Symbol* symtab_lookup(const Symtab* st, const char* name) {
 
     uint32_t hash = symtab_hash(name);
 
-    const Symtab* current_st = st;
-    while (current_st){
-        size_t idx = hash % current_st->size;
-        Symbol* current = current_st->slots[idx];
-        while (current) {
-            if (current->hash == hash &&
-                (strcmp(name, current->name) == 0)){
-                return current;
-            }
-            current = current->next;
-        }
-        current_st = current_st->parent;
+    for (const Symtab* current_st = st; current_st; current_st = current_st->parent) {
+        Symbol* sym = slots_find(current_st, hash, name);
+        if (sym) return sym;
     }
     return NULL;
 }
 
 Symbol* symtab_lookup_local(const Symtab* st, const char* name) {
     if (!st || !name) return NULL;
+    return slots_find(st, symtab_hash(name), name);
+}
 
-    uint32_t hash = symtab_hash(name);
-    size_t idx = hash % st->size;
+Symbol* symtab_define_ref(Symtab* st, const SymRef* ref, Cons* value, bool is_const) {
+    if (!st || !ref) return NULL;
 
-    Symbol* current = st->slots[idx];
-    while (current) {
-        if (current->hash == hash && 
-            (strcmp(name, current->name) == 0)){
-                return current;
+    Symbol* existing = slots_find(st, ref->hash, ref->name);
+    if (existing) {
+        if (existing->is_const) {
+            return NULL;
         }
-        current = current->next;
+        existing->value = value;
+        existing->is_const = is_const;
+        return existing;
     }
 
+    /* The intern pool owns the canonical name; no copy needed. */
+    Symbol rec = {
+        .name = ref->name,
+        .value = value,
+        .hash = ref->hash,
+        .is_const = is_const,
+    };
+
+    Symbol* sym = slots_insert(st, rec);
+    st->count++;
+
+    /* A new binding may shadow what cached sites resolved to. */
+    symtab_generation++;
+
+    symtab_grow(st);
+
+    return sym;
+}
+
+Symbol* symtab_lookup_local_ref(const Symtab* st, const SymRef* ref) {
+    if (!st || !ref) return NULL;
+    return slots_find(st, ref->hash, ref->name);
+}
+
+Symbol* symtab_lookup_ref(const Symtab* st, const SymRef* ref) {
+    if (!st || !ref) return NULL;
+
+    for (const Symtab* current_st = st; current_st; current_st = current_st->parent) {
+        Symbol* sym = slots_find(current_st, ref->hash, ref->name);
+        if (sym) return sym;
+    }
     return NULL;
 }
 
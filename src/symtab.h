@@ -7,28 +7,51 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 #include "arena.h"
+#include "intern.h"
 #include "parser.h"
 
-#define SYMTAB_INITIAL_SIZE 64
+#define SYMTAB_INITIAL_SIZE 64      ///< Slots in a global scope (power of two)
+#define SYMTAB_CHILD_SIZE 16        ///< Slots in a child scope (power of two)
 #define SYMTAB_LOAD_FACTOR 0.75
 
+/*
+ * Open-addressing storage: symbols live inline in a flat Symbol array
+ * with a parallel hash array, probed linearly with Robin Hood insertion
+ * (entries are kept ordered by probe distance). A lookup scans
+ * contiguous memory instead of chasing per-entry chain pointers; the
+ * parallel hash array keeps the common miss/skip comparisons inside a
+ * single cache line.
+ */
 typedef struct Symbol {
-    const char* name;           ///< Symbol name (interned string)
+    const char* name;           ///< Symbol name (interned string), NULL = empty slot
     Cons* value;                ///< Symbol value (can be any Cons type)
-    struct Symbol* next;        ///< Next symbol in hash chain (for collision resolution)
     uint32_t hash;              ///< Cached hash value
     bool is_const;              ///< Is this symbol immutable?
 } Symbol;
 
 typedef struct Symtab {
-    Symbol** slots;             ///< Array of Symbol* (hash buckets)
-    size_t size;                ///< Number of slots
+    Symbol* slots;              ///< Flat array of records (open addressing)
+    uint32_t* hashes;           ///< Parallel probe array of slot hashes
+    size_t size;                ///< Number of slots (always a power of two)
     size_t count;               ///< Number of symbols stored
     struct Symtab* parent;      ///< Parent scope (NULL for global)
     Arena** arena;              ///< Arena for allocations
 } Symtab;
 
+/**
+ * Resolution generation, bumped whenever a new symbol is inserted (it
+ * may shadow what a name previously resolved to) or a table rehashes
+ * (records move, invalidating Symbol pointers). Inline caches at
+ * reference sites compare this against their fill-time snapshot and
+ * re-resolve on mismatch (@see eval.c); plain value updates through
+ * symtab_set leave records in place and do not bump it. Atomic because
+ * pmap workers (@see builtin_pmap) may define into their call frames
+ * concurrently; the load on the cached read path is still a plain mov.
+ */
+extern _Atomic uint64_t symtab_generation;
+
 /* --------------- Core API ------------ */
 
 /**
@@ -47,6 +70,9 @@ Symtab* symtab_new(Symtab* parent, Arena** arena);
  * @param is_const Determine if the Symbol is constant and
  *                  promote the existent symbol if not already constant
  * @return The symbol, or NULL on error
+ *
+ * @warning Returned Symbol pointers are stable only until the next
+ *          define in the same scope (a rehash moves records).
  */
 Symbol* symtab_define(Symtab* st, const char* name, Cons* value, bool is_const);
 
@@ -66,6 +92,31 @@ Symbol* symtab_lookup(const Symtab* st, const char* name);
  */
 Symbol* symtab_lookup_local(const Symtab* st, const char* name);
 
+/**
+ * @brief Define a symbol through an interned reference (hot path).
+ *
+ * Uses the SymRef's cached hash and stores the pool's canonical name
+ * pointer directly — no symtab_hash, no name copy.
+ * @see symtab_define for semantics.
+ */
+Symbol* symtab_define_ref(Symtab* st, const SymRef* ref, Cons* value, bool is_const);
+
+/**
+ * @brief Lookup through an interned reference (hot path).
+ *
+ * Probes with the cached hash and compares names by pointer first
+ * (interned names are canonical), falling back to strcmp only for
+ * symbols defined through the string API.
+ * @see symtab_lookup for semantics.
+ */
+Symbol* symtab_lookup_ref(const Symtab* st, const SymRef* ref);
+
+/**
+ * @brief Lookup through an interned reference in this scope only.
+ * @see symtab_lookup_local for semantics.
+ */
+Symbol* symtab_lookup_local_ref(const Symtab* st, const SymRef* ref);
+
 /**
  * @brief Set value of existing symbol (respects const)
  * @param st Symbol table
@@ -0,0 +1,79 @@
+/**
+ * @file value.h
+ * @brief Tagged 64-bit value words for the evaluator hot path.
+ *
+ * Every Wisp value is nominally a heap Cons — a type tag, a cdr, a size
+ * field and a payload (@see parser.h) — which for a plain integer is
+ * ~40 bytes and an indirection when the interesting data is one machine
+ * word. Value packs either a Cons* or an immediate fixnum into a single
+ * uint64_t:
+ *
+ *   bit 0 = 0  the word is a Cons* (arena cells are max_align_t
+ *              aligned, so the low bits of a real pointer are zero)
+ *   bit 0 = 1  the word is a 63-bit signed fixnum, stored shifted
+ *              left by one
+ *
+ * Low-bit tagging is used instead of NaN boxing because floats here are
+ * long double (the 80-bit x87 payload cannot live inside a 64-bit NaN);
+ * floats stay heap-allocated, as do strings, lists and closures. nil
+ * and the booleans are already allocation-free shared cells
+ * (@see cells.h), so they stay pointers. Integers outside the fixnum
+ * range round-trip through the heap representation unchanged.
+ */
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <stdint.h>
+
+#include "parser.h"
+#include "cells.h"
+
+typedef uint64_t Value;
+
+#define FIXNUM_MIN (-(1ll << 62))
+#define FIXNUM_MAX ((1ll << 62) - 1)
+
+static inline bool value_is_fixnum(Value v) {
+    return (v & 1u) != 0;
+}
+
+static inline bool fixnum_fits(long long i) {
+    return i >= FIXNUM_MIN && i <= FIXNUM_MAX;
+}
+
+static inline Value value_fixnum(long long i) {
+    return ((uint64_t)i << 1) | 1u;
+}
+
+static inline long long value_as_fixnum(Value v) {
+    return (long long)((int64_t)v >> 1);
+}
+
+static inline Value value_ptr(Cons* c) {
+    return (Value)(uintptr_t)c;
+}
+
+static inline Cons* value_as_ptr(Value v) {
+    return (Cons*)(uintptr_t)v;
+}
+
+/** Decode a cell: ints that fit become immediate fixnums. */
+static inline Value value_from_cons(Cons* c) {
+    if (c && c->type == NODE_ATOM_INT) {
+        long long i = *(const long long*)c->car;
+        if (fixnum_fits(i)) return value_fixnum(i);
+    }
+    return value_ptr(c);
+}
+
+/** Re-box a word as a cell; the shared pool (@see cells.h) makes this
+ *  allocation-free for small fixnums. */
+static inline Cons* value_box(Value v, Arena** arena) {
+    if (!value_is_fixnum(v)) return value_as_ptr(v);
+    long long i = value_as_fixnum(v);
+    Cons* shared = cell_int(i);
+    if (shared) return shared;
+    return make_atom(&i, sizeof(i), NODE_ATOM_INT, arena);
+}
+
+#endif /* VALUE_H */
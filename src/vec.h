@@ -290,4 +290,47 @@ static inline int vec_clear(Vec *v_ptr)
 }
 
 
+/* ---------------- Monomorphic accessor generation ---------------- */
+
+/**
+ * @def VEC_DEFINE(T)
+ * @brief Instantiate inline typed accessors for a Vec holding T.
+ *
+ * The generic API routes every element through runtime elem_size
+ * arithmetic and an opaque memcpy, which hot loops pay per element.
+ * VEC_DEFINE(T) generates vec_T_at / vec_T_push / vec_T_pop with the
+ * element size known at compile time, so access compiles down to plain
+ * indexed moves. T must be a single identifier — typedef pointer or
+ * qualified types first. Semantics match the generic calls: push does
+ * not grow (returns -2 when full) and pop returns -2 when empty; the
+ * generic API remains for cold paths.
+ */
+#define VEC_DEFINE(T)                                                       \
+static inline T *vec_##T##_data(const Vec *v)                               \
+{                                                                           \
+    return (T *) (v + 1);                                                   \
+}                                                                           \
+static inline T vec_##T##_at(const Vec *v, size_t idx)                      \
+{                                                                           \
+    return ((const T *) (v + 1))[idx];                                      \
+}                                                                           \
+static inline int vec_##T##_push(Vec *v, T value)                           \
+{                                                                           \
+    if (v->elem_num >= v->maxcap)                                           \
+        return -2;                                                          \
+    ((T *) (v + 1))[v->elem_num++] = value;                                 \
+    v->bump_ptr += sizeof(T);                                               \
+    return 0;                                                               \
+}                                                                           \
+static inline int vec_##T##_pop(Vec *v, T *out)                             \
+{                                                                           \
+    if (v->elem_num == 0)                                                   \
+        return -2;                                                          \
+    v->elem_num--;                                                          \
+    v->bump_ptr -= sizeof(T);                                               \
+    if (out)                                                                \
+        *out = ((const T *) (v + 1))[v->elem_num];                          \
+    return 0;                                                               \
+}
+
 #endif
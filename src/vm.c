@@ -0,0 +1,666 @@
+/*
+ * @file vm.c
+ */
+#include "vm.h"
+#include "builtins.h"
+#include "cells.h"
+#include "intern.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define CODE_INITIAL_CAP 256
+#define CONST_INITIAL_CAP 64
+#define VM_STACK_INITIAL 256
+
+/* ------------ Compiler state ------------ */
+
+typedef struct Compiler {
+    Vec* code;          ///< Vec<uint8_t>
+    Vec* consts;        ///< Vec<Cons*>
+    Arena** arena;
+} Compiler;
+
+static int emit_byte(Compiler* c, uint8_t b) {
+    return arena_vec_push(&c->code, &b, c->arena);
+}
+
+static int emit_u16(Compiler* c, uint16_t v) {
+    uint8_t lo = (uint8_t)(v & 0xFF);
+    uint8_t hi = (uint8_t)(v >> 8);
+    if (emit_byte(c, lo) != 0) return -1;
+    return emit_byte(c, hi);
+}
+
+static size_t code_pos(const Compiler* c) {
+    return vec_len(c->code);
+}
+
+/*
+ * Backpatch a u16 jump operand once its target is known. Positions are
+ * byte indices, so they stay valid when the code vector reallocates.
+ */
+static int patch_u16(Compiler* c, size_t operand_pos, size_t target) {
+    if (target > UINT16_MAX) {
+        fprintf(stderr, "Compile Error: Code exceeds the 16-bit jump range.\n");
+        return -1;
+    }
+    uint8_t* code = (uint8_t*)(c->code + 1);
+    code[operand_pos] = (uint8_t)(target & 0xFF);
+    code[operand_pos + 1] = (uint8_t)(target >> 8);
+    return 0;
+}
+
+static int add_const(Compiler* c, Cons* value, uint16_t* idx_out) {
+    size_t n = vec_len(c->consts);
+    if (n >= UINT16_MAX) {
+        fprintf(stderr, "Compile Error: Constant pool overflow.\n");
+        return -1;
+    }
+    if (arena_vec_push(&c->consts, &value, c->arena) != 0) return -1;
+    *idx_out = (uint16_t)n;
+    return 0;
+}
+
+/* Emit an opcode carrying a constant-pool reference. */
+static int emit_const_op(Compiler* c, OpCode op, Cons* value) {
+    uint16_t idx;
+    if (add_const(c, value, &idx) != 0) return -1;
+    if (emit_byte(c, op) != 0) return -1;
+    return emit_u16(c, idx);
+}
+
+static bool sym_is(const Cons* c, const char* name) {
+    return c->type == NODE_ATOM_SYM &&
+           strcmp(((const SymRef*)c->car)->name, name) == 0;
+}
+
+static int compile_expr(Compiler* c, Cons* expr);
+
+/*
+ * Escape hatch for forms the compiler does not lower (capture-planned
+ * lambdas, slot-resolved locals, malformed forms whose diagnostics
+ * belong to the evaluator): the whole form becomes a constant and
+ * OP_EVAL hands it to the tree evaluator at run time.
+ */
+static int compile_defer(Compiler* c, Cons* expr) {
+    return emit_const_op(c, OP_EVAL, expr);
+}
+
+/*
+ * Compile a call form (op arg...) where op resolved to a builtin:
+ * arguments are evaluated left to right onto the stack, then a single
+ * OP_CALL_BUILTIN with the dispatch-table index baked in.
+ */
+static int compile_call(Compiler* c, BuiltinType type, const ConsList* form) {
+    size_t argc = form->length - 1;
+    if (argc > UINT8_MAX) {
+        fprintf(stderr, "Compile Error: Too many arguments in call.\n");
+        return -1;
+    }
+
+    for (Cons* arg = form->head->cdr; arg; arg = arg->cdr) {
+        if (compile_expr(c, arg) != 0) return -1;
+    }
+
+    if (emit_byte(c, OP_CALL_BUILTIN) != 0) return -1;
+    if (emit_byte(c, (uint8_t)type) != 0) return -1;
+    return emit_byte(c, (uint8_t)argc);
+}
+
+/*
+ * Computed call: the operator is any expression (a global closure, an
+ * immediate lambda, a call returning a procedure). It is evaluated
+ * first, arguments stack above it, and OP_CALL_VALUE applies through
+ * the evaluator's procedure dispatch (@see eval_apply_value).
+ */
+static int compile_call_value(Compiler* c, const ConsList* form) {
+    size_t argc = form->length - 1;
+    if (argc > UINT8_MAX) {
+        fprintf(stderr, "Compile Error: Too many arguments in call.\n");
+        return -1;
+    }
+
+    if (compile_expr(c, form->head) != 0) return -1;
+    for (Cons* arg = form->head->cdr; arg; arg = arg->cdr) {
+        if (compile_expr(c, arg) != 0) return -1;
+    }
+
+    if (emit_byte(c, OP_CALL_VALUE) != 0) return -1;
+    return emit_byte(c, (uint8_t)argc);
+}
+
+static int compile_if(Compiler* c, Cons* head) {
+    Cons* cond = head->cdr;
+    Cons* then_b = cond ? cond->cdr : NULL;
+    if (!cond || !then_b) {
+        fprintf(stderr, "Compile Error: 'if' expects a condition and a branch.\n");
+        return -1;
+    }
+
+    if (compile_expr(c, cond) != 0) return -1;
+
+    if (emit_byte(c, OP_JUMP_IF_FALSE) != 0) return -1;
+    size_t else_operand = code_pos(c);
+    if (emit_u16(c, 0) != 0) return -1;
+
+    if (compile_expr(c, then_b) != 0) return -1;
+
+    if (emit_byte(c, OP_JUMP) != 0) return -1;
+    size_t end_operand = code_pos(c);
+    if (emit_u16(c, 0) != 0) return -1;
+
+    if (patch_u16(c, else_operand, code_pos(c)) != 0) return -1;
+    if (then_b->cdr) {
+        if (compile_expr(c, then_b->cdr) != 0) return -1;
+    } else {
+        /* A missing else branch yields nil, as in the evaluator. */
+        if (emit_const_op(c, OP_CONST, cell_nil()) != 0) return -1;
+    }
+    return patch_u16(c, end_operand, code_pos(c));
+}
+
+static int compile_define(Compiler* c, Cons* head) {
+    Cons* target = head->cdr;
+    if (!target) {
+        fprintf(stderr, "Compile Error: 'define' expects a name.\n");
+        return -1;
+    }
+
+    if (target->type == NODE_ATOM_SYM) {
+        Cons* value = target->cdr;
+        if (!value) {
+            fprintf(stderr, "Compile Error: 'define' expects a value.\n");
+            return -1;
+        }
+        if (compile_expr(c, value) != 0) return -1;
+        return emit_const_op(c, OP_DEFINE, target);
+    }
+
+    /* (define (f a b) body...) procedure shorthand: synthesize the
+     * parameter list at compile time and close over it like a lambda. */
+    if (target->type == NODE_LIST) {
+        ConsList* sig = *(ConsList**)target->car;
+        if (!sig || !sig->head || sig->head->type != NODE_ATOM_SYM) {
+            fprintf(stderr, "Compile Error: malformed 'define' signature.\n");
+            return -1;
+        }
+        ConsList* params = (ConsList*)arena_alloc(c->arena, sizeof(ConsList));
+        if (!params) return -1;
+        params->head = sig->head->cdr;
+        params->tail = sig->head->cdr ? sig->tail : NULL;
+        params->length = sig->length - 1;
+
+        /* OP_CLOSURE wants a lambda-shaped cell: params in the car, the
+         * body chain in the cdr. wrap_list gives a fresh cell to link. */
+        Cons* cell = wrap_list(params, c->arena);
+        if (!cell) return -1;
+        cell->cdr = target->cdr;
+
+        if (emit_const_op(c, OP_CLOSURE, cell) != 0) return -1;
+        return emit_const_op(c, OP_DEFINE, sig->head);
+    }
+
+    fprintf(stderr, "Compile Error: 'define' target must be a symbol or a signature.\n");
+    return -1;
+}
+
+static int compile_begin(Compiler* c, Cons* head) {
+    Cons* form = head->cdr;
+    if (!form) {
+        return emit_const_op(c, OP_CONST, cell_nil());
+    }
+    for (; form; form = form->cdr) {
+        if (compile_expr(c, form) != 0) return -1;
+        if (form->cdr && emit_byte(c, OP_POP) != 0) return -1;
+    }
+    return 0;
+}
+
+static int compile_expr(Compiler* c, Cons* expr) {
+    if (!expr) return -1;
+
+    switch (expr->type) {
+        case NODE_LIST: {
+            const ConsList* form = *(ConsList* const*)expr->car;
+
+            if (!form || !form->head) {
+                /* () is just the empty list constant. */
+                break;
+            }
+
+            Cons* head = form->head;
+
+            if (head->type == NODE_BUILTIN) {
+                /* Already resolved by the parse-time pass. */
+                return compile_call(c, *(const BuiltinType*)head->car, form);
+            }
+
+            if (head->type == NODE_ATOM_SYM) {
+                if (sym_is(head, "quote")) {
+                    if (!head->cdr) {
+                        fprintf(stderr, "Compile Error: 'quote' expects one form.\n");
+                        return -1;
+                    }
+                    return emit_const_op(c, OP_CONST, head->cdr);
+                }
+                if (sym_is(head, "if"))     return compile_if(c, head);
+                if (sym_is(head, "define")) return compile_define(c, head);
+                if (sym_is(head, "begin"))  return compile_begin(c, head);
+
+                if (sym_is(head, "set!")) {
+                    Cons* target = head->cdr;
+                    Cons* value = target ? target->cdr : NULL;
+                    if (!target || !value || target->type != NODE_ATOM_SYM) {
+                        /* Slot-resolved or malformed: the evaluator owns
+                         * those paths and their diagnostics. */
+                        return compile_defer(c, expr);
+                    }
+                    if (compile_expr(c, value) != 0) return -1;
+                    return emit_const_op(c, OP_SET, target);
+                }
+
+                if (sym_is(head, "lambda")) {
+                    Cons* params_node = head->cdr;
+                    if (!params_node || params_node->type != NODE_LIST) {
+                        /* NODE_LAMBDA_SIG needs an activation record to
+                         * materialize captures from: defer it. */
+                        return compile_defer(c, expr);
+                    }
+                    return emit_const_op(c, OP_CLOSURE, params_node);
+                }
+
+                const SymRef* ref = (const SymRef*)head->car;
+                const struct BuiltinName* b =
+                    find_builtin(ref->name, strlen(ref->name));
+                if (b) {
+                    return compile_call(c, b->type, form);
+                }
+            }
+
+            /* User procedure (by name or computed operator). */
+            return compile_call_value(c, form);
+        }
+
+        case NODE_ATOM_SYM: {
+            return emit_const_op(c, OP_LOAD, expr);
+        }
+
+        case NODE_LOCAL_REF: {
+            /* Needs the frame's activation record; only the evaluator
+             * carries one. */
+            return compile_defer(c, expr);
+        }
+
+        case NODE_QUOTE: {
+            /* 'x evaluates to x: the payload is the constant. */
+            expr = *(Cons* const*)expr->car;
+            break;
+        }
+
+        case NODE_QUASIQUOTE:
+        case NODE_UNQUOTE: {
+            /* Templates are expanded at parse time; anything still here
+             * is data, as in the evaluator. */
+            expr = *(Cons* const*)expr->car;
+            break;
+        }
+
+        case NODE_OPENING_SEPARATOR:
+        case NODE_CLOSING_SEPARATOR: {
+            fprintf(stderr, "Compile Error: Parser artifact in AST.\n");
+            return -1;
+        }
+
+        default:
+            break;
+    }
+
+    /* Literals and quoted data: reference the arena-resident cell directly. */
+    return emit_const_op(c, OP_CONST, expr);
+}
+
+Chunk* compile_program(const ConsList* program, Arena** arena) {
+    if (!program || !arena || !*arena) return NULL;
+
+    Compiler c;
+    c.arena = arena;
+    c.code = arena_vec_new(arena, sizeof(uint8_t), CODE_INITIAL_CAP);
+    c.consts = arena_vec_new(arena, sizeof(Cons*), CONST_INITIAL_CAP);
+    if (!c.code || !c.consts) return NULL;
+
+    for (Cons* form = program->head; form; form = form->cdr) {
+        if (compile_expr(&c, form) != 0) return NULL;
+        /* Every form leaves one value; drop all but the last. */
+        if (form->cdr) {
+            if (emit_byte(&c, OP_POP) != 0) return NULL;
+        }
+    }
+    if (emit_byte(&c, OP_HALT) != 0) return NULL;
+
+    Chunk* chunk = (Chunk*)arena_alloc(arena, sizeof(Chunk));
+    if (!chunk) return NULL;
+    chunk->code = (const uint8_t*)(c.code + 1);
+    chunk->code_len = vec_len(c.code);
+    chunk->consts = (Cons* const*)(c.consts + 1);
+    chunk->const_count = vec_len(c.consts);
+    return chunk;
+}
+
+/* ------------ Dispatch loop ------------ */
+
+/*
+ * Pop argc values into a fresh ConsList for the uniform builtin_fn
+ * signature. Atom cells are shallow-cloned so builtins that retain their
+ * argument list (e.g. 'list') never splice shared constant-pool cells.
+ */
+static ConsList* collect_args(Cons** stack, size_t* sp, uint8_t argc, Arena** arena) {
+    ConsList* args = (ConsList*)arena_alloc(arena, sizeof(ConsList));
+    if (!args) return NULL;
+    cons_list_init(args);
+
+    size_t base = *sp - argc;
+    for (size_t i = 0; i < argc; i++) {
+        Cons* clone = cons_clone_shallow(stack[base + i], arena);
+        if (!clone) return NULL;
+        cons_list_push_back(args, clone);
+    }
+    *sp = base;
+    return args;
+}
+
+/* Same truthiness rule as the evaluator's F_IF: anything but nil. */
+static bool vm_truthy(const Cons* c) {
+    return c && c->type != NODE_NIL;
+}
+
+static Cons* vm_exec(const Chunk* chunk, Symtab* globals, Arena** arena) {
+    size_t stack_cap = VM_STACK_INITIAL;
+    Cons** stack = (Cons**)arena_alloc(arena, sizeof(Cons*) * stack_cap);
+    if (!stack) return NULL;
+    size_t sp = 0;
+
+    const uint8_t* ip = chunk->code;
+
+#define FETCH_U16() (ip += 2, (uint16_t)(ip[-2] | (ip[-1] << 8)))
+#define PUSH(v)                                                         \
+    do {                                                                \
+        if (sp >= stack_cap) {                                          \
+            size_t new_cap = stack_cap * 2;                             \
+            Cons** ns = (Cons**)arena_alloc(arena, sizeof(Cons*) * new_cap); \
+            if (!ns) return NULL;                                       \
+            memcpy(ns, stack, sizeof(Cons*) * stack_cap);               \
+            stack = ns;                                                 \
+            stack_cap = new_cap;                                        \
+        }                                                               \
+        stack[sp++] = (v);                                              \
+    } while (0)
+
+#if defined(__GNUC__)
+    static const void* dispatch[] = {
+        [OP_CONST]         = &&do_const,
+        [OP_LOAD]          = &&do_load,
+        [OP_CALL_BUILTIN]  = &&do_call_builtin,
+        [OP_CALL_VALUE]    = &&do_call_value,
+        [OP_JUMP]          = &&do_jump,
+        [OP_JUMP_IF_FALSE] = &&do_jump_if_false,
+        [OP_DEFINE]        = &&do_define,
+        [OP_SET]           = &&do_set,
+        [OP_CLOSURE]       = &&do_closure,
+        [OP_EVAL]          = &&do_eval,
+        [OP_POP]           = &&do_pop,
+        [OP_HALT]          = &&do_halt,
+    };
+
+#define DISPATCH() goto *dispatch[*ip++]
+
+    DISPATCH();
+
+do_const: {
+        uint16_t idx = FETCH_U16();
+        PUSH(chunk->consts[idx]);
+        DISPATCH();
+    }
+
+do_load: {
+        uint16_t idx = FETCH_U16();
+        const SymRef* ref = (const SymRef*)chunk->consts[idx]->car;
+        Symbol* sym = symtab_lookup_ref(globals, ref);
+        if (!sym) {
+            /* A bare builtin name denotes itself (see apply). */
+            if (find_builtin(ref->name, strlen(ref->name))) {
+                PUSH(chunk->consts[idx]);
+                DISPATCH();
+            }
+            fprintf(stderr, "Eval Error: unbound symbol '%s'.\n", ref->name);
+            return NULL;
+        }
+        PUSH(sym->value);
+        DISPATCH();
+    }
+
+do_call_builtin: {
+        uint8_t type = *ip++;
+        uint8_t argc = *ip++;
+        ConsList* args = collect_args(stack, &sp, argc, arena);
+        if (!args) return NULL;
+        Cons* result = builtin_dispatch_table[type](args, arena);
+        if (!result) return NULL;
+        PUSH(result);
+        DISPATCH();
+    }
+
+do_call_value: {
+        uint8_t argc = *ip++;
+        ConsList* args = collect_args(stack, &sp, argc, arena);
+        if (!args || sp == 0) return NULL;
+        Cons* op = stack[--sp];
+        Cons* result = eval_apply_value(op, args, arena);
+        if (!result) return NULL;
+        PUSH(result);
+        DISPATCH();
+    }
+
+do_jump: {
+        ip = chunk->code + FETCH_U16();
+        DISPATCH();
+    }
+
+do_jump_if_false: {
+        uint16_t target = FETCH_U16();
+        Cons* cond = sp > 0 ? stack[--sp] : NULL;
+        if (!vm_truthy(cond)) ip = chunk->code + target;
+        DISPATCH();
+    }
+
+do_define: {
+        uint16_t idx = FETCH_U16();
+        const SymRef* ref = (const SymRef*)chunk->consts[idx]->car;
+        if (sp == 0) return NULL;
+        /* The value stays on the stack: define yields it. */
+        if (!symtab_define_ref(globals, ref, stack[sp - 1], false)) {
+            fprintf(stderr, "Eval Error: cannot redefine constant '%s'.\n",
+                    ref->name);
+            return NULL;
+        }
+        DISPATCH();
+    }
+
+do_set: {
+        uint16_t idx = FETCH_U16();
+        const SymRef* ref = (const SymRef*)chunk->consts[idx]->car;
+        if (sp == 0) return NULL;
+        Symbol* sym = symtab_lookup_ref(globals, ref);
+        if (!sym) {
+            fprintf(stderr, "Eval Error: 'set!' on unbound symbol '%s'.\n",
+                    ref->name);
+            return NULL;
+        }
+        if (sym->is_const) {
+            fprintf(stderr, "Eval Error: 'set!' on constant '%s'.\n",
+                    ref->name);
+            return NULL;
+        }
+        sym->value = stack[sp - 1];
+        DISPATCH();
+    }
+
+do_closure: {
+        uint16_t idx = FETCH_U16();
+        Cons* cell = chunk->consts[idx];
+        ConsList* params = *(ConsList**)cell->car;
+        Cons* lam = eval_make_closure(params, cell->cdr, globals, arena);
+        if (!lam) return NULL;
+        PUSH(lam);
+        DISPATCH();
+    }
+
+do_eval: {
+        uint16_t idx = FETCH_U16();
+        Cons* result = eval_expr(chunk->consts[idx], globals, arena);
+        if (!result) return NULL;
+        PUSH(result);
+        DISPATCH();
+    }
+
+do_pop: {
+        if (sp > 0) sp--;
+        DISPATCH();
+    }
+
+do_halt:
+    return sp > 0 ? stack[sp - 1] : NULL;
+
+#else /* portable switch fallback */
+    for (;;) {
+        switch ((OpCode)*ip++) {
+            case OP_CONST: {
+                uint16_t idx = FETCH_U16();
+                PUSH(chunk->consts[idx]);
+                break;
+            }
+            case OP_LOAD: {
+                uint16_t idx = FETCH_U16();
+                const SymRef* ref = (const SymRef*)chunk->consts[idx]->car;
+                Symbol* sym = symtab_lookup_ref(globals, ref);
+                if (!sym) {
+                    if (find_builtin(ref->name, strlen(ref->name))) {
+                        PUSH(chunk->consts[idx]);
+                        break;
+                    }
+                    fprintf(stderr, "Eval Error: unbound symbol '%s'.\n", ref->name);
+                    return NULL;
+                }
+                PUSH(sym->value);
+                break;
+            }
+            case OP_CALL_BUILTIN: {
+                uint8_t type = *ip++;
+                uint8_t argc = *ip++;
+                ConsList* args = collect_args(stack, &sp, argc, arena);
+                if (!args) return NULL;
+                Cons* result = builtin_dispatch_table[type](args, arena);
+                if (!result) return NULL;
+                PUSH(result);
+                break;
+            }
+            case OP_CALL_VALUE: {
+                uint8_t argc = *ip++;
+                ConsList* args = collect_args(stack, &sp, argc, arena);
+                if (!args || sp == 0) return NULL;
+                Cons* op = stack[--sp];
+                Cons* result = eval_apply_value(op, args, arena);
+                if (!result) return NULL;
+                PUSH(result);
+                break;
+            }
+            case OP_JUMP: {
+                ip = chunk->code + FETCH_U16();
+                break;
+            }
+            case OP_JUMP_IF_FALSE: {
+                uint16_t target = FETCH_U16();
+                Cons* cond = sp > 0 ? stack[--sp] : NULL;
+                if (!vm_truthy(cond)) ip = chunk->code + target;
+                break;
+            }
+            case OP_DEFINE: {
+                uint16_t idx = FETCH_U16();
+                const SymRef* ref = (const SymRef*)chunk->consts[idx]->car;
+                if (sp == 0) return NULL;
+                if (!symtab_define_ref(globals, ref, stack[sp - 1], false)) {
+                    fprintf(stderr, "Eval Error: cannot redefine constant '%s'.\n",
+                            ref->name);
+                    return NULL;
+                }
+                break;
+            }
+            case OP_SET: {
+                uint16_t idx = FETCH_U16();
+                const SymRef* ref = (const SymRef*)chunk->consts[idx]->car;
+                if (sp == 0) return NULL;
+                Symbol* sym = symtab_lookup_ref(globals, ref);
+                if (!sym) {
+                    fprintf(stderr, "Eval Error: 'set!' on unbound symbol '%s'.\n",
+                            ref->name);
+                    return NULL;
+                }
+                if (sym->is_const) {
+                    fprintf(stderr, "Eval Error: 'set!' on constant '%s'.\n",
+                            ref->name);
+                    return NULL;
+                }
+                sym->value = stack[sp - 1];
+                break;
+            }
+            case OP_CLOSURE: {
+                uint16_t idx = FETCH_U16();
+                Cons* cell = chunk->consts[idx];
+                ConsList* params = *(ConsList**)cell->car;
+                Cons* lam = eval_make_closure(params, cell->cdr, globals, arena);
+                if (!lam) return NULL;
+                PUSH(lam);
+                break;
+            }
+            case OP_EVAL: {
+                uint16_t idx = FETCH_U16();
+                Cons* result = eval_expr(chunk->consts[idx], globals, arena);
+                if (!result) return NULL;
+                PUSH(result);
+                break;
+            }
+            case OP_POP: {
+                if (sp > 0) sp--;
+                break;
+            }
+            case OP_HALT:
+                return sp > 0 ? stack[sp - 1] : NULL;
+        }
+    }
+#endif
+
+#undef DISPATCH
+#undef PUSH
+#undef FETCH_U16
+}
+
+Cons* vm_run(const Chunk* chunk, Symtab* globals, Arena** arena) {
+    if (!chunk || !chunk->code || !globals || !arena || !*arena) return NULL;
+    if (intern_init(globals->arena) != 0) return NULL;
+
+    /* 'nil' reads as a plain symbol; bind it once as a constant. */
+    SymRef nil_ref;
+    if (intern_ref(&nil_ref, "nil", 3) != 0) return NULL;
+    if (!symtab_lookup_ref(globals, &nil_ref)) {
+        if (!symtab_define_ref(globals, &nil_ref, cell_nil(), true)) {
+            return NULL;
+        }
+    }
+
+    /* eval/apply/pmap resolve through the running program's global
+     * scope; point them at ours for the duration of the chunk. */
+    Symtab* prev_global = eval_set_global_env(globals);
+    Cons* result = vm_exec(chunk, globals, arena);
+    eval_set_global_env(prev_global);
+    return result;
+}
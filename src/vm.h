@@ -0,0 +1,95 @@
+/**
+ * @file vm.h
+ * @brief Bytecode compiler and dispatch VM for parsed programs.
+ *
+ * A post-parse pipeline stage: compile_program lowers the ConsList AST
+ * into a flat arena-allocated bytecode array with builtin_dispatch_table
+ * indices baked into OP_CALL_BUILTIN, and vm_run executes it with a
+ * computed-goto dispatch loop (switch fallback on non-GNU compilers).
+ * This replaces per-node pointer chasing and NodeType re-dispatch with a
+ * linear instruction fetch.
+ *
+ * The compiler covers the special forms the evaluator supports at the
+ * top level (quote, if, define, set!, lambda, begin) plus builtin and
+ * computed calls; closure application re-enters the evaluator (@see
+ * eval_apply_value), which keeps a single binding and tail-call
+ * implementation for lambda bodies. Any form the compiler cannot lower
+ * becomes an OP_EVAL deferral to the tree evaluator, so compilation
+ * succeeds for every program the evaluator accepts. wisp-bench runs the
+ * chunk as a bytecode stage timed against the tree walk.
+ */
+#ifndef VM_H
+#define VM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "arena.h"
+#include "parser.h"
+#include "symtab.h"
+
+/**
+ * @enum OpCode
+ * @brief Instruction set of the Wisp VM.
+ *
+ * Operands are encoded little-endian directly after the opcode byte.
+ * Jump operands are absolute code offsets, which caps a chunk at 64 KB
+ * of code; compile_program reports overflow as an error.
+ */
+typedef enum OpCode : uint8_t {
+    OP_CONST,           ///< u16 const-pool index: push a constant
+    OP_LOAD,            ///< u16 const-pool index of a NODE_ATOM_SYM: push its Symtab value
+    OP_CALL_BUILTIN,    ///< u8 BuiltinType, u8 argc: pop argc args, push result
+    OP_CALL_VALUE,      ///< u8 argc: pop argc args and the operator under them, apply, push result
+    OP_JUMP,            ///< u16 code offset: unconditional branch
+    OP_JUMP_IF_FALSE,   ///< u16 code offset: pop the condition, branch when it is nil
+    OP_DEFINE,          ///< u16 sym index: bind the top of stack in globals (value stays)
+    OP_SET,             ///< u16 sym index: assign the existing binding (value stays)
+    OP_CLOSURE,         ///< u16 const index of a params cell (cdr = body): push a closure
+    OP_EVAL,            ///< u16 const index of a form: defer it to the tree evaluator
+    OP_POP,             ///< Discard the top of stack (between top-level forms)
+    OP_HALT             ///< Stop; top of stack (if any) is the program result
+} OpCode;
+
+/**
+ * @struct Chunk
+ * @brief A compiled program: flat code array plus constant pool.
+ */
+typedef struct Chunk {
+    const uint8_t* code;        ///< Bytecode stream, terminated by OP_HALT
+    size_t code_len;            ///< Bytes in code
+    Cons* const* consts;        ///< Constant pool (arena-resident AST cells)
+    size_t const_count;         ///< Entries in consts
+} Chunk;
+
+/* --------------- Compiler / VM API ------------ */
+
+/**
+ * @brief Lower a parsed program into bytecode.
+ *
+ * Call forms whose head is a builtin compile to OP_CALL_BUILTIN, other
+ * calls to OP_CALL_VALUE; the supported special forms get dedicated
+ * opcodes; quoted data and literals become constant-pool references and
+ * bare symbols OP_LOAD. Anything else (for instance a capture-planned
+ * inner lambda, @see LambdaSig) compiles to OP_EVAL.
+ *
+ * @return The compiled chunk, or NULL on error.
+ */
+Chunk* compile_program(const ConsList* program, Arena** arena);
+
+/**
+ * @brief Execute a compiled chunk.
+ *
+ * Binds 'nil' in @p globals the way eval_program does. Values are
+ * allocated from @p arena with no scratch/persistent split, so
+ * @p globals must live in the same arena (eval_program's single-arena
+ * mode, where promotion is a no-op).
+ *
+ * @param chunk Compiled program.
+ * @param globals Global symbol table (loads, defines, deferred forms).
+ * @param arena Arena for values produced during execution.
+ * @return The value of the last top-level form, or NULL on error.
+ */
+Cons* vm_run(const Chunk* chunk, Symtab* globals, Arena** arena);
+
+#endif
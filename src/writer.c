@@ -0,0 +1,99 @@
+/*
+ * @file writer.c
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "writer.h"
+
+int writer_init(Writer* w, size_t initial_cap) {
+    if (!w) return -1;
+    if (initial_cap < 64) initial_cap = 64;
+    w->buf = (char*)malloc(initial_cap);
+    w->len = 0;
+    w->cap = w->buf ? initial_cap : 0;
+    w->oom = (w->buf == NULL);
+    return w->oom ? -1 : 0;
+}
+
+void writer_destroy(Writer* w) {
+    if (!w) return;
+    free(w->buf);
+    w->buf = NULL;
+    w->len = 0;
+    w->cap = 0;
+}
+
+/* Ensure room for n more bytes; sets the sticky oom flag on failure. */
+static char* writer_reserve(Writer* w, size_t n) {
+    if (w->oom) return NULL;
+    if (w->len + n > w->cap) {
+        size_t new_cap = w->cap ? w->cap * 2 : 64;
+        while (new_cap < w->len + n) new_cap *= 2;
+        char* nb = (char*)realloc(w->buf, new_cap);
+        if (!nb) {
+            w->oom = true;
+            return NULL;
+        }
+        w->buf = nb;
+        w->cap = new_cap;
+    }
+    return w->buf + w->len;
+}
+
+void writer_bytes(Writer* w, const void* data, size_t n) {
+    char* dst = writer_reserve(w, n);
+    if (!dst) return;
+    memcpy(dst, data, n);
+    w->len += n;
+}
+
+void writer_str(Writer* w, const char* s) {
+    writer_bytes(w, s, strlen(s));
+}
+
+void writer_char(Writer* w, char c) {
+    char* dst = writer_reserve(w, 1);
+    if (!dst) return;
+    *dst = c;
+    w->len += 1;
+}
+
+void writer_int(Writer* w, long long v) {
+    /* Digits are produced in reverse into a stack buffer; 20 digits
+     * cover the 64-bit range, plus the sign. */
+    char tmp[24];
+    char* p = tmp + sizeof(tmp);
+    unsigned long long u = (v < 0) ? -(unsigned long long)v : (unsigned long long)v;
+
+    do {
+        *--p = (char)('0' + (u % 10));
+        u /= 10;
+    } while (u);
+    if (v < 0) *--p = '-';
+
+    writer_bytes(w, p, (size_t)(tmp + sizeof(tmp) - p));
+}
+
+void writer_float(Writer* w, long double v) {
+    /* Floats are rare in output; snprintf keeps the formatting
+     * identical to what display always printed. */
+    char tmp[48];
+    int n = snprintf(tmp, sizeof(tmp), "%Lg", v);
+    if (n > 0) writer_bytes(w, tmp, (size_t)n);
+}
+
+int writer_flush(Writer* w, FILE* stream) {
+    if (w->oom) {
+        w->len = 0;
+        return -1;
+    }
+    if (w->len) {
+        if (fwrite(w->buf, 1, w->len, stream) != w->len) {
+            w->len = 0;
+            return -1;
+        }
+        w->len = 0;
+    }
+    return 0;
+}
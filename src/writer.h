@@ -0,0 +1,73 @@
+/**
+ * @file writer.h
+ * @brief Growable byte buffer for batched output.
+ *
+ * The printers used to issue one fprintf per atom, paren and space —
+ * stdio locking plus format-string parsing per element, which makes
+ * dumping a large structure crawl. Writer batches formatted output in a
+ * malloc'd buffer (the same cold-path growth pattern as the image
+ * writer) and hands the whole thing to stdio in a single fwrite.
+ * Integers are formatted with a branch-free digit loop instead of
+ * printf machinery; strings are memcpy'd with their known length.
+ *
+ * Errors are sticky: after an allocation failure every append is a
+ * no-op and writer_flush reports the failure once.
+ */
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef struct Writer {
+    char* buf;
+    size_t len;
+    size_t cap;
+    bool oom;
+} Writer;
+
+/**
+ * @brief Initialize with a malloc'd buffer of @p initial_cap bytes.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int writer_init(Writer* w, size_t initial_cap);
+
+/**
+ * @brief Release the buffer.
+ */
+void writer_destroy(Writer* w);
+
+/**
+ * @brief Append @p n raw bytes.
+ */
+void writer_bytes(Writer* w, const void* data, size_t n);
+
+/**
+ * @brief Append a NUL-terminated string (the NUL is not written).
+ */
+void writer_str(Writer* w, const char* s);
+
+/**
+ * @brief Append one byte.
+ */
+void writer_char(Writer* w, char c);
+
+/**
+ * @brief Append a decimal integer without going through printf.
+ */
+void writer_int(Writer* w, long long v);
+
+/**
+ * @brief Append a float formatted as display/%Lg would print it.
+ */
+void writer_float(Writer* w, long double v);
+
+/**
+ * @brief Hand the buffered bytes to @p stream in one fwrite and reset
+ *        the length (capacity is kept for reuse).
+ * @return 0 on success, -1 if buffering or the write failed.
+ */
+int writer_flush(Writer* w, FILE* stream);
+
+#endif /* WRITER_H */